@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "poly.h"
+#include "timer.h"
+
+/* --- Manifest --- */
+// Μία γραμμή ανά ζεύγος:  <degree n> [seed]   (seed default 42)
+// Κενές γραμμές και γραμμές που ξεκινούν με '#' αγνοούνται.
+// Τα πολυώνυμα κάθε ζεύγους παράγονται στον Master με srand(seed), όπως στο ex3_1.
+static int read_manifest(const char *path, int **degrees, int **seeds) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    int cap = 64, count = 0;
+    *degrees = (int*) malloc(cap * sizeof(int));
+    *seeds = (int*) malloc(cap * sizeof(int));
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        int deg, seed = 42;
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+        int got = sscanf(p, "%d %d", &deg, &seed);
+        if (got < 1 || deg < 0) continue;
+        if (count == cap) {
+            cap *= 2;
+            *degrees = (int*) realloc(*degrees, cap * sizeof(int));
+            *seeds = (int*) realloc(*seeds, cap * sizeof(int));
+        }
+        (*degrees)[count] = deg;
+        (*seeds)[count] = seed;
+        count++;
+    }
+    fclose(fp);
+    return count;
+}
+
+/* --- Κατάσταση ενός ζεύγους που βρίσκεται "σε πτήση" --- */
+typedef struct {
+    int N, res_size;
+    int *A, *B;              // A: μόνο στον Master, B: σε όλους (Ibcast)
+    int *local_A;
+    long long *local_C, *final_C;
+    int *counts, *displs;    // Μπλοκ κατανομή του A (οποιοδήποτε N, P)
+    MPI_Request dist[2];     // Iscatterv + Ibcast
+    MPI_Request reduce;      // Ireduce
+    double t_post;           // Χρονική στιγμή εκκίνησης της διανομής
+} batch_slot_t;
+
+// Εκκίνηση (μη-ανασταλτικής) διανομής του ζεύγους στη θέση sl
+static void post_distribution(batch_slot_t *sl, int degree, int seed, int my_rank, int comm_sz) {
+    sl->N = degree + 1;
+    sl->res_size = 2 * sl->N - 1;
+    sl->counts = (int*) malloc(comm_sz * sizeof(int));
+    sl->displs = (int*) malloc(comm_sz * sizeof(int));
+    for (int r = 0; r < comm_sz; r++) {
+        sl->displs[r] = (int) ((long long) r * sl->N / comm_sz);
+        sl->counts[r] = (int) ((long long) (r + 1) * sl->N / comm_sz) - sl->displs[r];
+    }
+    sl->B = (int*) malloc(sl->N * sizeof(int));
+    sl->local_A = (int*) malloc((sl->counts[my_rank] + 1) * sizeof(int));
+    sl->local_C = (long long*) calloc(sl->res_size, sizeof(long long));
+    sl->A = NULL;
+    sl->final_C = NULL;
+
+    GET_TIME(sl->t_post);
+    if (my_rank == 0) {
+        sl->A = (int*) malloc(sl->N * sizeof(int));
+        sl->final_C = (long long*) malloc(sl->res_size * sizeof(long long));
+        srand(seed);
+        for (int i = 0; i < sl->N; i++) {
+            sl->A[i] = (rand() % 10) + 1;
+            sl->B[i] = (rand() % 10) + 1;
+        }
+    }
+
+    MPI_Iscatterv(sl->A, sl->counts, sl->displs, MPI_INT,
+                  sl->local_A, sl->counts[my_rank], MPI_INT, 0, MPI_COMM_WORLD, &sl->dist[0]);
+    MPI_Ibcast(sl->B, sl->N, MPI_INT, 0, MPI_COMM_WORLD, &sl->dist[1]);
+}
+
+// Έλεγχος ορθότητας χωρίς O(N^2): Σ C_k = (Σ A_i) * (Σ B_j)
+static int checksum_ok(const batch_slot_t *sl) {
+    long long sa = 0, sb = 0, sc = 0;
+    for (int i = 0; i < sl->N; i++) { sa += sl->A[i]; sb += sl->B[i]; }
+    for (int k = 0; k < sl->res_size; k++) sc += sl->final_C[k];
+    return sc == sa * sb;
+}
+
+static void free_slot(batch_slot_t *sl) {
+    free(sl->A); free(sl->B); free(sl->local_A); free(sl->local_C); free(sl->final_C);
+    free(sl->counts); free(sl->displs);
+}
+
+/* --- Batch: πολλά γινόμενα με μία εκκίνηση του MPI --- */
+// Pipeline τριών θέσεων (slots):
+//   επανάληψη k: εκκίνηση διανομής k+1 | αναμονή διανομής k | υπολογισμός k |
+//                Ireduce k | ολοκλήρωση Ireduce k-1
+// Έτσι η διανομή του επόμενου ζεύγους και η αναγωγή του προηγούμενου
+// "τρέχουν" ενώ υπολογίζεται το τρέχον.
+void mult_batch(const mult_opts_t *opt, phase_times_t *t) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+
+    int npairs = 0;
+    int *degrees = NULL, *seeds = NULL;
+    if (my_rank == 0) {
+        npairs = read_manifest(opt->manifest, &degrees, &seeds);
+        if (npairs < 0) printf("Error: cannot open manifest %s\n", opt->manifest);
+    }
+    MPI_Bcast(&npairs, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (npairs <= 0) {
+        t->comm = t->calc = t->work = t->reduce = 0.0;
+        free(degrees); free(seeds);
+        return;
+    }
+    if (my_rank != 0) {
+        degrees = (int*) malloc(npairs * sizeof(int));
+        seeds = (int*) calloc(npairs, sizeof(int));
+    }
+    MPI_Bcast(degrees, npairs, MPI_INT, 0, MPI_COMM_WORLD);
+
+    batch_slot_t slot[3];
+    double t_wait_dist = 0.0, t_calc = 0.0, t_wait_reduce = 0.0;
+    double t0, t1, t_start, t_end;
+    double *latency = (double*) malloc(npairs * sizeof(double));
+    int failures = 0;
+    double flops = 0.0;
+
+    if (my_rank == 0) {
+        printf("Batch: %d pairs from %s\n", npairs, opt->manifest);
+        printf("%8s %10s %14s %8s\n", "pair", "degree", "latency (sec)", "check");
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_start);
+
+    post_distribution(&slot[0], degrees[0], seeds[0], my_rank, comm_sz);
+
+    for (int k = 0; k < npairs; k++) {
+        batch_slot_t *cur = &slot[k % 3];
+
+        // 1. Η διανομή του επόμενου ζεύγους ξεκινά πριν τον υπολογισμό του τρέχοντος
+        if (k + 1 < npairs)
+            post_distribution(&slot[(k + 1) % 3], degrees[k + 1], seeds[k + 1], my_rank, comm_sz);
+
+        // 2. Αναμονή των δεδομένων του τρέχοντος ζεύγους
+        GET_TIME(t0);
+        MPI_Waitall(2, cur->dist, MPI_STATUSES_IGNORE);
+        GET_TIME(t1);
+        t_wait_dist += t1 - t0;
+
+        // 3. Υπολογισμός (tiled πυρήνας, int64)
+        conv_tiled(cur->local_A, cur->counts[my_rank], cur->B, cur->N,
+                   cur->local_C + cur->displs[my_rank]);
+        GET_TIME(t0);
+        t_calc += t0 - t1;
+        flops += 2.0 * cur->N * cur->N;
+
+        // 4. Μη-ανασταλτική αναγωγή του τρέχοντος ζεύγους
+        MPI_Ireduce(cur->local_C, cur->final_C, cur->res_size, MPI_LONG_LONG, MPI_SUM,
+                    0, MPI_COMM_WORLD, &cur->reduce);
+
+        // 5. Ολοκλήρωση του προηγούμενου ζεύγους
+        if (k >= 1) {
+            batch_slot_t *prev = &slot[(k - 1) % 3];
+            GET_TIME(t0);
+            MPI_Wait(&prev->reduce, MPI_STATUS_IGNORE);
+            GET_TIME(t1);
+            t_wait_reduce += t1 - t0;
+            latency[k - 1] = t1 - prev->t_post;
+            if (my_rank == 0) {
+                int ok = checksum_ok(prev);
+                failures += !ok;
+                printf("%8d %10d %14e %8s\n", k - 1, degrees[k - 1], latency[k - 1], ok ? "OK" : "FAIL");
+            }
+            free_slot(prev);
+        }
+    }
+
+    batch_slot_t *last = &slot[(npairs - 1) % 3];
+    GET_TIME(t0);
+    MPI_Wait(&last->reduce, MPI_STATUS_IGNORE);
+    GET_TIME(t1);
+    t_wait_reduce += t1 - t0;
+    latency[npairs - 1] = t1 - last->t_post;
+    if (my_rank == 0) {
+        int ok = checksum_ok(last);
+        failures += !ok;
+        printf("%8d %10d %14e %8s\n", npairs - 1, degrees[npairs - 1], latency[npairs - 1], ok ? "OK" : "FAIL");
+    }
+    free_slot(last);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_end);
+
+    if (my_rank == 0) {
+        double sum_lat = 0.0, max_lat = 0.0;
+        for (int k = 0; k < npairs; k++) {
+            sum_lat += latency[k];
+            if (latency[k] > max_lat) max_lat = latency[k];
+        }
+        double wall = t_end - t_start;
+        printf("--------------------------------------\n");
+        printf("Batch wall time:        %e sec\n", wall);
+        printf("Mean / max latency:     %e / %e sec\n", sum_lat / npairs, max_lat);
+        printf("Throughput:             %.2f pairs/sec, %.3f GFLOP/s\n", npairs / wall, flops / wall / 1e9);
+        printf("Checksums:              %s (%d failed)\n", failures ? "FAILED" : "PASSED", failures);
+    }
+
+    t->comm = t_wait_dist;
+    t->calc = t_calc;
+    t->work = t_calc;
+    t->reduce = t_wait_reduce;
+
+    free(latency); free(degrees); free(seeds);
+}
@@ -0,0 +1,77 @@
+#!/bin/bash
+
+# --- Sweep μετρήσεων με το harness (bench.h) ---
+# Κάθε συνδυασμός τρέχει με warm-up + REPS επαναλήψεις και γράφει μία γραμμή
+# ανά φάση στο CSV (min/median/max ως προς επαναλήψεις και διεργασίες).
+# Στο τέλος υπολογίζονται speedup S(P) = T(P_min) / T(P) και efficiency
+# E(P) = S(P) * P_min / P από τον median χρόνο της φάσης "total".
+#
+# Όλες οι ρυθμίσεις αλλάζουν από το περιβάλλον, π.χ.
+#   DEGREES="31999" PROCESSES="1 2 4" MPIEXEC="mpiexec --oversubscribe" ./bench3_1.sh
+
+DEGREES=${DEGREES:-"3199 31999 102399 204799"}
+PROCESSES=${PROCESSES:-"1 2 4 8 16 32"}
+ENGINES=${ENGINES:-"schoolbook tiled"}
+THREADS=${THREADS:-1}
+REPS=${REPS:-5}
+WARMUP=${WARMUP:-1}
+
+MACHINES_FILE=${MACHINES_FILE:-machines}
+MPIEXEC=${MPIEXEC:-"mpiexec -f $MACHINES_FILE"}
+CSV_FILE=${CSV_FILE:-bench_ex3_1.csv}
+TABLE_FILE=${TABLE_FILE:-speedup_ex3_1.dat}
+LOG_FILE=${LOG_FILE:-bench_ex3_1.log}
+
+# --- Compile ---
+echo "--- Compiling Project ---"
+make
+
+if [ ! -f ./ex3_1 ]; then
+    echo "❌ Error: Compilation failed!"
+    exit 1
+fi
+
+rm -f $CSV_FILE $LOG_FILE
+
+# --- Loops ---
+echo "🚀 Starting Experiments ..."
+
+for engine in $ENGINES; do
+    for n in $DEGREES; do
+        N=$((n+1))
+        for p in $PROCESSES; do
+            # Safety Check: τουλάχιστον ένας συντελεστής ανά διεργασία
+            if (( N < p )); then
+                continue
+            fi
+            echo "   Running: engine=$engine | n=$n | P=$p"
+            $MPIEXEC -n $p ./ex3_1 -m $engine -t $THREADS -r $REPS -u $WARMUP -R $CSV_FILE $n >> $LOG_FILE
+        done
+    done
+done
+
+# --- Speedup / efficiency ---
+# Μία ομάδα ανά συνδυασμό παραμέτρων (όλες οι στήλες εκτός του P), χωρισμένες
+# με κενή γραμμή: στο gnuplot κάθε ομάδα είναι ένα "index".
+awk -F, -v PHASE=total '
+NR == 1 {
+    for (i = 1; i <= NF; i++) { col[$i] = i; name[i] = $i }
+    stats = col["phase"]
+    next
+}
+$stats == PHASE {
+    key = ""
+    for (i = 1; i < stats; i++) if (i != col["P"]) key = key sprintf("%s=%s ", name[i], $i)
+    if (!(key in base)) { order[++nkeys] = key; base[key] = $col["median"]; pmin[key] = $col["P"] }
+    rows[key] = rows[key] sprintf("%6d %14e %9.3f %9.3f\n", $col["P"], $col["median"],
+                                  base[key] / $col["median"],
+                                  base[key] / $col["median"] * pmin[key] / $col["P"])
+}
+END {
+    for (k = 1; k <= nkeys; k++) {
+        printf("# %s(phase %s)\n# %4s %14s %9s %9s\n%s\n\n", order[k], PHASE, "P", "median", "speedup", "effic.", rows[order[k]])
+    }
+}' $CSV_FILE > $TABLE_FILE
+
+echo "✅ All experiments finished!"
+echo "📄 Raw results: $CSV_FILE, speedup tables: $TABLE_FILE"
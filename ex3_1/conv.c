@@ -0,0 +1,177 @@
+#include <stdlib.h>
+#include <immintrin.h>
+#include "poly.h"
+
+/* --- Schoolbook Συνέλιξη --- */
+// Ίδιος διπλός βρόχος με τον αρχικό πυρήνα του ex3_1, σε 64-bit ακεραίους.
+// Χρησιμοποιείται ως βάση της αναδρομής (Karatsuba / Toom-3).
+void conv_schoolbook(const long long *a, int na, const long long *b, int nb, long long *c) {
+    for (int i = 0; i < na; i++) {
+        long long ai = a[i];
+        for (int j = 0; j < nb; j++) {
+            c[i + j] += ai * b[j];
+        }
+    }
+}
+
+/* ======================================================
+   Tiled / SIMD πυρήνας: c[k] += Σ_i a[i] * b[k-i]
+   ======================================================
+   Αντί για scattered read-modify-write στο c[i+j] για κάθε ζεύγος (i, j),
+   κρατάμε ένα μπλοκ BW διαδοχικών εξόδων c[k0..k0+BW) σε καταχωρητές
+   (register blocking) και για κάθε i προσθέτουμε a[i] * b[k0-i .. k0-i+BW),
+   που είναι ΣΥΝΕΧΕΣ τμήμα του b. Το A χωρίζεται σε πλακίδια CONV_TILE_I
+   ώστε το παράθυρο του b που διατρέχουν διαδοχικά μπλοκ να μένει στην cache.
+   Τα γινόμενα συσσωρεύονται σε int64 (δεν υπάρχει υπερχείλιση του int). */
+
+#define CONV_TILE_I 2048   // Όροι του A ανά πλακίδιο
+#define CONV_PAD    64     // Μηδενικά εκατέρωθεν του b (>= μέγιστο BW)
+
+typedef void (*conv_block_fn)(const int *a, int ilo, int ihi, const int *bk, long long *c);
+
+/* --- Scalar μπλοκ: 16 έξοδοι --- */
+#define BW_SCALAR 16
+static void block_scalar(const int *a, int ilo, int ihi, const int *bk, long long *c) {
+    long long acc[BW_SCALAR];
+    for (int l = 0; l < BW_SCALAR; l++) acc[l] = c[l];
+    for (int i = ilo; i < ihi; i++) {
+        long long ai = a[i];
+        const int *bb = bk - i;   // bb[l] = b[k0 + l - i]
+        for (int l = 0; l < BW_SCALAR; l++) acc[l] += ai * bb[l];
+    }
+    for (int l = 0; l < BW_SCALAR; l++) c[l] = acc[l];
+}
+
+/* --- AVX2 μπλοκ: 4 καταχωρητές x 4 int64 = 16 έξοδοι --- */
+#define BW_AVX2 16
+__attribute__((target("avx2")))
+static void block_avx2(const int *a, int ilo, int ihi, const int *bk, long long *c) {
+    __m256i acc0 = _mm256_loadu_si256((const __m256i*) (c + 0));
+    __m256i acc1 = _mm256_loadu_si256((const __m256i*) (c + 4));
+    __m256i acc2 = _mm256_loadu_si256((const __m256i*) (c + 8));
+    __m256i acc3 = _mm256_loadu_si256((const __m256i*) (c + 12));
+    for (int i = ilo; i < ihi; i++) {
+        __m256i va = _mm256_set1_epi64x(a[i]);
+        const int *bb = bk - i;
+        // Επέκταση προσήμου 32 -> 64 bit και γινόμενο των χαμηλών 32 bit (προσημασμένο)
+        __m256i b0 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*) (bb + 0)));
+        __m256i b1 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*) (bb + 4)));
+        __m256i b2 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*) (bb + 8)));
+        __m256i b3 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*) (bb + 12)));
+        acc0 = _mm256_add_epi64(acc0, _mm256_mul_epi32(va, b0));
+        acc1 = _mm256_add_epi64(acc1, _mm256_mul_epi32(va, b1));
+        acc2 = _mm256_add_epi64(acc2, _mm256_mul_epi32(va, b2));
+        acc3 = _mm256_add_epi64(acc3, _mm256_mul_epi32(va, b3));
+    }
+    _mm256_storeu_si256((__m256i*) (c + 0), acc0);
+    _mm256_storeu_si256((__m256i*) (c + 4), acc1);
+    _mm256_storeu_si256((__m256i*) (c + 8), acc2);
+    _mm256_storeu_si256((__m256i*) (c + 12), acc3);
+}
+
+/* --- AVX-512 μπλοκ: 4 καταχωρητές x 8 int64 = 32 έξοδοι --- */
+#define BW_AVX512 32
+__attribute__((target("avx512f")))
+static void block_avx512(const int *a, int ilo, int ihi, const int *bk, long long *c) {
+    __m512i acc0 = _mm512_loadu_si512((const void*) (c + 0));
+    __m512i acc1 = _mm512_loadu_si512((const void*) (c + 8));
+    __m512i acc2 = _mm512_loadu_si512((const void*) (c + 16));
+    __m512i acc3 = _mm512_loadu_si512((const void*) (c + 24));
+    for (int i = ilo; i < ihi; i++) {
+        __m512i va = _mm512_set1_epi64(a[i]);
+        const int *bb = bk - i;
+        __m512i b0 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i*) (bb + 0)));
+        __m512i b1 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i*) (bb + 8)));
+        __m512i b2 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i*) (bb + 16)));
+        __m512i b3 = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i*) (bb + 24)));
+        acc0 = _mm512_add_epi64(acc0, _mm512_mul_epi32(va, b0));
+        acc1 = _mm512_add_epi64(acc1, _mm512_mul_epi32(va, b1));
+        acc2 = _mm512_add_epi64(acc2, _mm512_mul_epi32(va, b2));
+        acc3 = _mm512_add_epi64(acc3, _mm512_mul_epi32(va, b3));
+    }
+    _mm512_storeu_si512((void*) (c + 0), acc0);
+    _mm512_storeu_si512((void*) (c + 8), acc1);
+    _mm512_storeu_si512((void*) (c + 16), acc2);
+    _mm512_storeu_si512((void*) (c + 24), acc3);
+}
+
+/* --- Επιλογή συνόλου εντολών (runtime) --- */
+static conv_isa_t selected_isa = CONV_AUTO;
+
+conv_isa_t conv_detect_isa(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return CONV_AVX512;
+    if (__builtin_cpu_supports("avx2")) return CONV_AVX2;
+    return CONV_SCALAR;
+}
+
+void conv_set_isa(conv_isa_t isa) {
+    // Δεν επιτρέπουμε ISA που δεν υποστηρίζει ο επεξεργαστής
+    conv_isa_t best = conv_detect_isa();
+    selected_isa = (isa == CONV_AUTO || isa > best) ? best : isa;
+}
+
+conv_isa_t conv_get_isa(void) {
+    if (selected_isa == CONV_AUTO) conv_set_isa(CONV_AUTO);
+    return selected_isa;
+}
+
+const char *conv_isa_name(conv_isa_t isa) {
+    switch (isa) {
+        case CONV_SCALAR: return "scalar";
+        case CONV_AVX2:   return "avx2";
+        case CONV_AVX512: return "avx512";
+        default:          return "auto";
+    }
+}
+
+void conv_tiled(const int *a, int na, const int *b, int nb, long long *c) {
+    if (na <= 0 || nb <= 0) return;
+
+    conv_block_fn block;
+    int bw;
+    switch (conv_get_isa()) {
+        case CONV_AVX512: block = block_avx512; bw = BW_AVX512; break;
+        case CONV_AVX2:   block = block_avx2;   bw = BW_AVX2;   break;
+        default:          block = block_scalar; bw = BW_SCALAR; break;
+    }
+
+    // Αντίγραφο του b με μηδενικά εκατέρωθεν: οι φορτώσεις b[k0-i .. k0-i+bw)
+    // στα άκρα διαβάζουν μηδενικά αντί για έλεγχο ορίων στον εσωτερικό βρόχο.
+    int *bp = (int*) calloc(nb + 2 * CONV_PAD, sizeof(int));
+    for (int j = 0; j < nb; j++) bp[CONV_PAD + j] = b[j];
+    const int *b0 = bp + CONV_PAD;
+
+    int nc = na + nb - 1;
+    int nc_main = (nc / bw) * bw;   // Έξοδοι που καλύπτονται από πλήρη μπλοκ
+
+    // Hybrid: τα νήματα μοιράζονται τα μπλοκ εξόδων κάθε πλακιδίου. Κάθε μπλοκ
+    // ανήκει σε ένα νήμα και το implicit barrier του omp for χωρίζει τα
+    // πλακίδια, οπότε δεν χρειάζονται atomics ούτε μερικά αντίγραφα του c.
+    #pragma omp parallel
+    for (int i0 = 0; i0 < na; i0 += CONV_TILE_I) {
+        int i1 = i0 + CONV_TILE_I < na ? i0 + CONV_TILE_I : na;
+
+        // Μπλοκ εξόδων που επηρεάζονται από τα a[i0..i1): k0 + bw > i0 και k0 < i1 + nb - 1
+        int k_first = i0 - bw + 1 > 0 ? ((i0 - bw + 1) / bw) * bw : 0;
+        int k_last = i1 + nb - 1 < nc_main ? i1 + nb - 1 : nc_main;
+
+        #pragma omp for schedule(static)
+        for (int k0 = k_first; k0 < k_last; k0 += bw) {
+            int ilo = k0 - nb + 1 > i0 ? k0 - nb + 1 : i0;
+            int ihi = k0 + bw < i1 ? k0 + bw : i1;
+            if (ilo < ihi) block(a, ilo, ihi, b0 + k0, c + k0);
+        }
+    }
+
+    // Ουρά: οι τελευταίες (< bw) έξοδοι υπολογίζονται απευθείας
+    for (int k = nc_main; k < nc; k++) {
+        int ilo = k - nb + 1 > 0 ? k - nb + 1 : 0;
+        int ihi = k < na - 1 ? k : na - 1;
+        long long sum = 0;
+        for (int i = ilo; i <= ihi; i++) sum += (long long) a[i] * b[k - i];
+        c[k] += sum;
+    }
+
+    free(bp);
+}
@@ -0,0 +1,109 @@
+/* File:     conv_bench.c
+ *
+ * Purpose:  Microbenchmark (μία διεργασία) του πυρήνα συνέλιξης: ο αρχικός
+ *           διπλός βρόχος του ex3_1 έναντι του tiled πυρήνα conv_tiled σε
+ *           κάθε διαθέσιμο σύνολο εντολών (scalar / AVX2 / AVX-512).
+ *
+ * Usage:    ./conv_bench [N ...]   (N = πλήθος συντελεστών, default 2000 8000 32000)
+ *
+ * Note:     1 multiply-add = 2 πράξεις, οπότε ένα N x N γινόμενο κοστίζει
+ *           2*N^2 (ακέραιες) πράξεις. Αναφέρουμε GFLOP/s = 2*N^2 / t / 1e9.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "poly.h"
+#include "timer.h"
+
+#define BENCH_REPS 3   // Κρατάμε τον καλύτερο από BENCH_REPS χρόνους
+
+// Πολύ μικρά N πέφτουν κάτω από την ανάλυση του timer (t = 0)
+static double gflops(double flops, double t) {
+    return t > 0.0 ? flops / t / 1e9 : 0.0;
+}
+
+/* --- Ο αρχικός πυρήνας του ex3_1 (local_n = N, global_offset = 0) --- */
+static void conv_original(const int *local_A, int local_n, const int *B, int N, int *local_C) {
+    int global_offset = 0;
+    for (int i = 0; i < local_n; i++) {
+        for (int j = 0; j < N; j++) {
+            int global_i = global_offset + i;
+            int c_index = global_i + j;
+            local_C[c_index] += local_A[i] * B[j];
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int default_sizes[] = { 2000, 8000, 32000 };
+    int nsizes = argc > 1 ? argc - 1 : 3;
+
+    // Μόνο για το MPI_Wtime του GET_TIME (μία διεργασία, καμία επικοινωνία)
+    MPI_Init(NULL, NULL);
+
+    // Κάθε N πρέπει να είναι θετικός ακέραιος (αλλιώς malloc(2N - 1) με N = 0)
+    for (int s = 1; s < argc; s++) {
+        char *end;
+        long N = strtol(argv[s], &end, 10);
+        if (end == argv[s] || *end != '\0' || N < 1 || N > 1000000000L) {
+            printf("Usage: %s [N ...]   (N >= 1 coefficients, default: 2000 8000 32000)\n", argv[0]);
+            MPI_Finalize(); return 0;
+        }
+    }
+
+    // Σύγκριση πυρήνων σε έναν πυρήνα CPU (ο αρχικός βρόχος είναι σειριακός)
+    omp_set_num_threads(1);
+
+    conv_isa_t best = conv_detect_isa();
+    printf("Best supported ISA: %s\n", conv_isa_name(best));
+    printf("%10s %-10s %14s %12s %8s\n", "N", "kernel", "time (sec)", "GFLOP/s", "check");
+
+    for (int s = 0; s < nsizes; s++) {
+        int N = argc > 1 ? atoi(argv[s + 1]) : default_sizes[s];
+        int res_size = 2 * N - 1;
+        double flops = 2.0 * N * N;
+
+        int *A = (int*) malloc(N * sizeof(int));
+        int *B = (int*) malloc(N * sizeof(int));
+        int *C_ref = (int*) malloc(res_size * sizeof(int));
+        long long *C = (long long*) malloc(res_size * sizeof(long long));
+
+        srand(42); // Ίδια δεδομένα με το ex3_1
+        for (int i = 0; i < N; i++) {
+            A[i] = (rand() % 10) + 1;
+            B[i] = (rand() % 10) + 1;
+        }
+
+        // Αρχικός βρόχος
+        double t0, t1, best_t = 1e30;
+        for (int r = 0; r < BENCH_REPS; r++) {
+            memset(C_ref, 0, res_size * sizeof(int));
+            GET_TIME(t0);
+            conv_original(A, N, B, N, C_ref);
+            GET_TIME(t1);
+            if (t1 - t0 < best_t) best_t = t1 - t0;
+        }
+        printf("%10d %-10s %14e %12.3f %8s\n", N, "original", best_t, gflops(flops, best_t), "-");
+
+        // Tiled πυρήνας για κάθε υποστηριζόμενο ISA
+        for (conv_isa_t isa = CONV_SCALAR; isa <= best; isa++) {
+            conv_set_isa(isa);
+            best_t = 1e30;
+            for (int r = 0; r < BENCH_REPS; r++) {
+                memset(C, 0, res_size * sizeof(long long));
+                GET_TIME(t0);
+                conv_tiled(A, N, B, N, C);
+                GET_TIME(t1);
+                if (t1 - t0 < best_t) best_t = t1 - t0;
+            }
+            int ok = 1;
+            for (int k = 0; k < res_size; k++) if (C[k] != C_ref[k]) { ok = 0; break; }
+            printf("%10d %-10s %14e %12.3f %8s\n", N, conv_isa_name(isa), best_t,
+                   gflops(flops, best_t), ok ? "OK" : "FAIL");
+        }
+
+        free(A); free(B); free(C_ref); free(C);
+    }
+    MPI_Finalize();
+    return 0;
+}
@@ -1,167 +1,562 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
 #include <mpi.h>
-#include "timer.h" 
+#include "timer.h"
+#include "bench.h"
+#include "perf.h"
+#include "poly.h"
 
-int main(int argc, char* argv[]) {
+/* --- Διανομή του A σε συνεχή μπλοκ --- */
+// Η διεργασία r παίρνει τους συντελεστές [r*N/P, (r+1)*N/P): οποιοδήποτε N >= P,
+// τα μπλοκ διαφέρουν το πολύ κατά ένα στοιχείο (Scatterv). Κάθε συντελεστής του A
+// κοστίζει N πολλαπλασιασμούς, οπότε ίσα μπλοκ σημαίνουν και ίσο φορτίο.
+static int scatter_blocks(const int *A, int N, int *local_A, int *global_offset) {
     int my_rank, comm_sz;
-    int n, N, local_n;
-    
-    // Αρχικοποίηση περιβάλλοντος MPI
-    MPI_Init(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
-
-    // Έλεγχος ορισμάτων εισόδου
-    if (argc != 2) {
-        if (my_rank == 0) printf("Usage: %s <degree n>\n", argv[0]);
-        MPI_Finalize();
-        return 0;
+    int *counts = (int*) malloc(comm_sz * sizeof(int));
+    int *displs = (int*) malloc(comm_sz * sizeof(int));
+    for (int r = 0; r < comm_sz; r++) {
+        displs[r] = (int) ((long long) r * N / comm_sz);
+        counts[r] = (int) ((long long) (r + 1) * N / comm_sz) - displs[r];
     }
+    int local_n = counts[my_rank];
+    *global_offset = displs[my_rank];
+    MPI_Scatterv(A, counts, displs, MPI_INT, local_A, local_n, MPI_INT, 0, MPI_COMM_WORLD);
+    free(counts); free(displs);
+    return local_n;
+}
 
-    n = atoi(argv[1]);
-    N = n + 1; // Πλήθος συντελεστών (βαθμός n -> n+1 όροι)
-
-    // Έλεγχος διαιρετότητας: Το N πρέπει να διαιρείται ακριβώς με το πλήθος διεργασιών
-    // για να λειτουργήσει σωστά η MPI_Scatter.
-    if (N % comm_sz != 0) {
-        if (my_rank == 0) {
-            printf("Error: Matrix size N=%d is not divisible by P=%d.\n", N, comm_sz);
-        }
-        MPI_Finalize();
-        return 0;
-    }
+/* --- Αρχική μηχανή: Schoolbook (Scatterv / Bcast / Reduce) --- */
+// shared: το B ζει σε ένα κοινόχρηστο παράθυρο ανά κόμβο αντί για ένα αντίγραφο ανά διεργασία
+// pf / pf_r: μετρητές υλικού γύρω από τον πυρήνα (-H, αλλιώς κενές κλήσεις)
+static void mult_schoolbook(const int *A, const int *B_root, int N, long long *final_C,
+                            int shared, perf_t *pf, int pf_r, phase_times_t *t) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
 
-    // Υπολογισμός του μεγέθους του πίνακα A που αναλογεί σε κάθε διεργασία
-    local_n = N / comm_sz;
+    // Υπολογισμός του (μέγιστου) μεγέθους του πίνακα A που αναλογεί σε κάθε διεργασία
+    int local_n = (N + comm_sz - 1) / comm_sz;
+    int global_offset;   // Από πού ξεκινάει το local_A (ορίζεται στη διανομή)
 
     /* --- Δέσμευση Μνήμης --- */
-    
+
     // 1. local_A: Αποθηκεύει το τμήμα του πίνακα A που θα επεξεργαστεί η διεργασία
     int *local_A = (int*) malloc(local_n * sizeof(int));
-    
+
     // 2. B: Αποθηκεύει ολόκληρο το πολυώνυμο B.
     // Χρειαζόμαστε όλο το B σε κάθε διεργασία για να γίνει σωστά η συνέλιξη (convolution).
-    int *B = (int*) malloc(N * sizeof(int));
+    // Με shared windows δεσμεύεται στη φάση επικοινωνίας, μία φορά ανά κόμβο.
+    int *B = NULL;
+    shm_buf_t shm;
+    if (!shared) {
+        B = (int*) malloc(N * sizeof(int));
+        if (my_rank == 0) memcpy(B, B_root, N * sizeof(int));
+    }
 
     // 3. local_C: Πίνακας για τα μερικά αποτελέσματα.
     // Το γινόμενο πολυωνύμων βαθμού n έχει βαθμό 2n, άρα μέγεθος 2n+1.
-    int res_size = 2 * n + 1;
+    int res_size = 2 * N - 1;
     // Χρήση calloc για αρχικοποίηση με 0, ώστε να κάνουμε += αργότερα.
-    int *local_C = (int*) calloc(res_size, sizeof(int)); 
-
-    // Δείκτες για τους Global πίνακες (χρήση μόνο από τον Master)
-    int *A = NULL;       
-    int *final_C = NULL; 
-    
-    // Ο Master δεσμεύει και αρχικοποιεί τα δεδομένα
-    if (my_rank == 0) {
-        A = (int*) malloc(N * sizeof(int));
-        final_C = (int*) malloc(res_size * sizeof(int));
-
-        printf("Master: Initializing polynomials (Degree n=%d, Coeffs N=%d)...\n", n, N);
-        srand(42); // Seed για επαναληψιμότητα των πειραμάτων
-        for (int i = 0; i < N; i++) {
-            A[i] = (rand() % 10) + 1; 
-            B[i] = (rand() % 10) + 1; 
-        }
-    }
+    int *local_C = (int*) calloc(res_size, sizeof(int));
 
     /* --- Φάση Επικοινωνίας (Distribution) --- */
-    
+
     double t_start, t_comm_end;
 
     // Barrier για να ξεκινήσει η χρονομέτρηση ταυτόχρονα
     MPI_Barrier(MPI_COMM_WORLD);
     GET_TIME(t_start);
 
-    // Διανομή του πίνακα A: Κάθε διεργασία παίρνει local_n στοιχεία
-    MPI_Scatter(A, local_n, MPI_INT, 
-                local_A, local_n, MPI_INT, 
-                0, MPI_COMM_WORLD);
+    // Διανομή του πίνακα A: Κάθε διεργασία παίρνει local_n στοιχεία (N / P ή N / P + 1)
+    local_n = scatter_blocks(A, N, local_A, &global_offset);
 
     // Broadcast του πίνακα B: Όλες οι διεργασίες λαμβάνουν όλο το B
-    MPI_Bcast(B, N, MPI_INT, 0, MPI_COMM_WORLD);
+    // (shared: μόνο οι leaders των κόμβων, οι υπόλοιποι διαβάζουν το κοινό αντίγραφο)
+    if (shared) B = shm_bcast_int(B_root, N, &shm);
+    else MPI_Bcast(B, N, MPI_INT, 0, MPI_COMM_WORLD);
 
-    MPI_Barrier(MPI_COMM_WORLD); 
+    MPI_Barrier(MPI_COMM_WORLD);
     GET_TIME(t_comm_end);
 
     // Debug print για επιβεβαίωση λήψης δεδομένων
     printf("Rank %d received local_A[0]=%d and B[0]=%d\n", my_rank, local_A[0], B[0]);
-    
+
 
     /* --- Φάση Υπολογισμού (Convolution Kernel) --- */
-    
-    double t_calc_end;
-    
-    // Υπολογισμός του global index από όπου ξεκινάει το local_A της διεργασίας
-    int global_offset = my_rank * local_n;
-
-    // Διπλός βρόχος για τον υπολογισμό του γινομένου (Συνέλιξη)
-    for (int i = 0; i < local_n; i++) {
-        for (int j = 0; j < N; j++) {
-            
-            // Ο τρέχων όρος του A αντιστοιχεί στη δύναμη x^(global_offset + i)
-            int global_i = global_offset + i;
-            
-            // Οι δυνάμεις προστίθενται στον πολλαπλασιασμό: x^a * x^b = x^(a+b)
-            int c_index = global_i + j;
-            
-            // Προσθήκη στο αντίστοιχο κελί του αποτελέσματος
-            local_C[c_index] += local_A[i] * B[j];
+
+    double t_work_end, t_calc_end;
+    perf_start(pf, pf_r);
+
+    // Διπλός βρόχος για τον υπολογισμό του γινομένου (Συνέλιξη).
+    // Hybrid: κάθε νήμα παίρνει ένα συνεχές τμήμα [i0, i1) του local_A.
+    // Το νήμα 0 γράφει κατευθείαν στο local_C, τα υπόλοιπα σε ιδιωτικό μερικό
+    // διάνυσμα που συγχωνεύεται μετά χωρίς atomics (κάθε κελί του local_C
+    // ενημερώνεται από ένα μόνο νήμα). Με 1 νήμα είναι ο αρχικός βρόχος.
+    int **part = (int**) calloc(omp_get_max_threads(), sizeof(int*));
+
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num(), nt = omp_get_num_threads();
+        int i0 = (int) ((long long) tid * local_n / nt);
+        int i1 = (int) ((long long) (tid + 1) * local_n / nt);
+
+        int *out = local_C;   // Το νήμα 0 γράφει με global δείκτες
+        int base = 0;
+        if (tid > 0) {
+            part[tid] = (int*) calloc(i1 - i0 + N, sizeof(int));
+            out = part[tid];
+            base = global_offset + i0;
+        }
+
+        for (int i = i0; i < i1; i++) {
+            for (int j = 0; j < N; j++) {
+
+                // Ο τρέχων όρος του A αντιστοιχεί στη δύναμη x^(global_offset + i)
+                int global_i = global_offset + i;
+
+                // Οι δυνάμεις προστίθενται στον πολλαπλασιασμό: x^a * x^b = x^(a+b)
+                int c_index = global_i + j;
+
+                // Προσθήκη στο αντίστοιχο κελί του αποτελέσματος
+                out[c_index - base] += local_A[i] * B[j];
+            }
         }
+
+        #pragma omp barrier
+
+        // Συγχώνευση των μερικών αποτελεσμάτων, παράλληλα ως προς τον δείκτη εξόδου
+        #pragma omp for schedule(static)
+        for (int c = global_offset; c < global_offset + local_n + N - 1; c++) {
+            for (int t = 1; t < nt; t++) {
+                int t0 = global_offset + (int) ((long long) t * local_n / nt);
+                int t_len = (int) ((long long) (t + 1) * local_n / nt) - (t0 - global_offset) + N - 1;
+                if (c >= t0 && c < t0 + t_len) local_C[c] += part[t][c - t0];
+            }
+        }
+
+        if (tid > 0) free(part[tid]);
     }
+    free(part);
 
-    MPI_Barrier(MPI_COMM_WORLD); 
+    GET_TIME(t_work_end);   // Τοπικός χρόνος, χωρίς την αναμονή στο barrier
+    // 2 πράξεις ανά ζεύγος (i, j). Bytes: local_A, B και ανάγνωση + εγγραφή του τμήματος του C
+    perf_stop(pf, pf_r, t_work_end - t_comm_end, 2.0 * local_n * N,
+              ((double) local_n + N + 2.0 * (local_n + N - 1)) * sizeof(int));
+    MPI_Barrier(MPI_COMM_WORLD);
     GET_TIME(t_calc_end);
 
     // Debug print για έλεγχο υπολογισμού
-    printf("Rank %d calculated partial C[%d] = %d\n", 
+    printf("Rank %d calculated partial C[%d] = %d\n",
            my_rank, global_offset, local_C[global_offset]);
-           
+
 
     /* --- Φάση Συλλογής & Αποτελέσματα (Reduction) --- */
 
     double t_reduce_end;
 
-    // Συγκέντρωση (Reduction) των μερικών πινάκων local_C στον final_C του Master.
+    // Συγκέντρωση (Reduction) των μερικών πινάκων local_C στον Master.
     // Χρησιμοποιούμε MPI_SUM για να αθροίσουμε τους συντελεστές που αντιστοιχούν στην ίδια δύναμη.
-    MPI_Reduce(local_C, final_C, res_size, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    int *sum_C = NULL;
+    if (my_rank == 0) sum_C = (int*) malloc(res_size * sizeof(int));
+    MPI_Reduce(local_C, sum_C, res_size, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
 
     GET_TIME(t_reduce_end);
 
+    // Ο αρχικός πυρήνας είναι σε int: απλή μετατροπή στην κοινή (int64) έξοδο
+    if (my_rank == 0) {
+        for (int i = 0; i < res_size; i++) final_C[i] = sum_C[i];
+        free(sum_C);
+    }
+
+    t->comm = t_comm_end - t_start;
+    t->calc = t_calc_end - t_comm_end;
+    t->work = t_work_end - t_comm_end;
+    t->reduce = t_reduce_end - t_calc_end;
+
+    // Αποδέσμευση μνήμης
+    free(local_A);
+    if (shared) shm_free(&shm);
+    else free(B);
+    free(local_C);
+}
+
+/* --- Tiled / SIMD μηχανή --- */
+// Ίδια διανομή με το schoolbook (Scatterv του A, Bcast του B, Reduce του C),
+// αλλά ο πυρήνας είναι ο conv_tiled (register blocking, AVX2/AVX-512) και η
+// συσσώρευση/αναγωγή γίνεται σε int64.
+static void mult_tiled(const int *A, const int *B_root, int N, long long *final_C,
+                       int shared, perf_t *pf, int pf_r, phase_times_t *t) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+
+    int local_n = (N + comm_sz - 1) / comm_sz, global_offset;
+    int res_size = 2 * N - 1;
+    int *local_A = (int*) malloc(local_n * sizeof(int));
+    int *B = NULL;
+    shm_buf_t shm;
+    if (!shared) {
+        B = (int*) malloc(N * sizeof(int));
+        if (my_rank == 0) memcpy(B, B_root, N * sizeof(int));
+    }
+    long long *local_C = (long long*) calloc(res_size, sizeof(long long));
+
+    double t_start, t_comm_end, t_work_end, t_calc_end, t_reduce_end;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_start);
+
+    local_n = scatter_blocks(A, N, local_A, &global_offset);
+    if (shared) B = shm_bcast_int(B_root, N, &shm);
+    else MPI_Bcast(B, N, MPI_INT, 0, MPI_COMM_WORLD);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_comm_end);
+
+    // Το local_A αντιστοιχεί στις δυνάμεις x^(global_offset + i)
+    perf_start(pf, pf_r);
+    conv_tiled(local_A, local_n, B, N, local_C + global_offset);
+
+    GET_TIME(t_work_end);   // Τοπικός χρόνος, χωρίς την αναμονή στο barrier
+    perf_stop(pf, pf_r, t_work_end - t_comm_end, 2.0 * local_n * N,
+              ((double) local_n + N) * sizeof(int) + 2.0 * (local_n + N - 1) * sizeof(long long));
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_calc_end);
+
+    MPI_Reduce(local_C, final_C, res_size, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    GET_TIME(t_reduce_end);
+
+    t->comm = t_comm_end - t_start;
+    t->calc = t_calc_end - t_comm_end;
+    t->work = t_work_end - t_comm_end;
+    t->reduce = t_reduce_end - t_calc_end;
+
+    free(local_A); free(local_C);
+    if (shared) shm_free(&shm);
+    else free(B);
+}
+
+/* --- Επαλήθευση --- */
+// Σειριακός υπολογισμός (schoolbook) στον Master και σύγκριση με το final_C.
+static int verify_result(const int *A, const int *B, int N, const long long *final_C) {
+    int res_size = 2 * N - 1;
+    long long *ref = (long long*) calloc(res_size, sizeof(long long));
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            ref[i + j] += (long long) A[i] * B[j];
+
+    int errors = 0;
+    for (int i = 0; i < res_size; i++) if (ref[i] != final_C[i]) errors++;
+    free(ref);
+    return errors;
+}
+
+static const char *mode_name(mult_mode_t mode) {
+    switch (mode) {
+        case MODE_KARATSUBA: return "karatsuba";
+        case MODE_TOOM3:     return "toom3";
+        case MODE_NTT:       return "ntt";
+        case MODE_OWNER:     return "owner";
+        case MODE_TILED:     return "tiled";
+        case MODE_STREAM:    return "stream";
+        case MODE_BATCH:     return "batch";
+        default:             return "schoolbook";
+    }
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [-m schoolbook|karatsuba|toom3|ntt|owner|tiled|stream] [-t threads] [-k threshold] [-l levels]\n"
+           "          [-x scalar|avx2|avx512] [-a A.bin] [-b B.bin] [-o C.bin] [-s segment] [-g]\n"
+           "          [-w] [-c] [-H] [-r reps] [-u warmup] [-R results.csv|.json] <degree n>\n", prog);
+    printf("       %s -m batch -f manifest [-t threads] [-x scalar|avx2|avx512]\n", prog);
+    printf("  -m  multiplication engine (default: schoolbook)\n");
+    printf("  -k  size below which Karatsuba/Toom-3 fall back to schoolbook (default: 32)\n");
+    printf("  -l  distributed recursion levels, 3^l subproblems (default: auto)\n");
+    printf("  -x  instruction set of the tiled kernel (default: best supported)\n");
+    printf("  -a/-b/-o  stream: int32 input files and int64 output file (default: A.bin B.bin C.bin)\n");
+    printf("  -s  stream: coefficients per segment (default: 65536)\n");
+    printf("  -g  stream: (re)create the input files with the default generator first\n");
+    printf("  -f  batch: manifest with one '<degree n> [seed]' line per pair\n");
+    printf("  -t  OpenMP threads per MPI rank (default: 1)\n");
+    printf("  -w  schoolbook/tiled: one shared copy of B per node (MPI-3 shared windows)\n");
+    printf("  -c  verify final_C against a serial schoolbook product on the Master\n");
+    printf("  -H  schoolbook/tiled: hardware counters (perf_event_open: cycles, instructions,\n"
+           "      LLC misses) around the convolution, GFLOP/s and GB/s vs a STREAM triad ceiling\n");
+    printf("  -r  timed repetitions (default: 1); reported times are medians over them\n");
+    printf("  -u  untimed warm-up runs before the repetitions (default: 0)\n");
+    printf("  -R  append min/median/max over reps and ranks to a CSV (or .json) file\n");
+}
+
+int main(int argc, char* argv[]) {
+    int my_rank, comm_sz;
+    int n, N;
+
+    // Αρχικοποίηση περιβάλλοντος MPI
+    // FUNNELED: μόνο το κύριο νήμα κάνει κλήσεις MPI (εκτός παράλληλων περιοχών)
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+
+    // Προεπιλογές: ο αρχικός αλγόριθμος
+    mult_opts_t opt = { MODE_SCHOOLBOOK, 32, -1, "A.bin", "B.bin", "C.bin", 65536, NULL, 0 };
+    int check = 0, generate = 0;
+    int hwperf = 0;                  // Μετρητές υλικού και roofline του πυρήνα (perf.h)
+    int nthreads = 1;
+    int reps = 1, warmup = 0;        // Harness μετρήσεων (bench.h)
+    const char *results = NULL;
+
+    // Έλεγχος ορισμάτων εισόδου
+    int c;
+    while ((c = getopt(argc, argv, "m:t:k:l:x:a:b:o:s:gf:wcHr:u:R:")) != -1) {
+        switch (c) {
+            case 'm':
+                if (strcmp(optarg, "schoolbook") == 0) opt.mode = MODE_SCHOOLBOOK;
+                else if (strcmp(optarg, "karatsuba") == 0) opt.mode = MODE_KARATSUBA;
+                else if (strcmp(optarg, "toom3") == 0) opt.mode = MODE_TOOM3;
+                else if (strcmp(optarg, "ntt") == 0) opt.mode = MODE_NTT;
+                else if (strcmp(optarg, "owner") == 0) opt.mode = MODE_OWNER;
+                else if (strcmp(optarg, "tiled") == 0) opt.mode = MODE_TILED;
+                else if (strcmp(optarg, "stream") == 0) opt.mode = MODE_STREAM;
+                else if (strcmp(optarg, "batch") == 0) opt.mode = MODE_BATCH;
+                else {
+                    if (my_rank == 0) usage(argv[0]);
+                    MPI_Finalize();
+                    return 0;
+                }
+                break;
+            case 't': nthreads = atoi(optarg); break;
+            case 'k': opt.threshold = atoi(optarg); break;
+            case 'l': opt.levels = atoi(optarg); break;
+            case 'x':
+                if (strcmp(optarg, "scalar") == 0) conv_set_isa(CONV_SCALAR);
+                else if (strcmp(optarg, "avx2") == 0) conv_set_isa(CONV_AVX2);
+                else if (strcmp(optarg, "avx512") == 0) conv_set_isa(CONV_AVX512);
+                else conv_set_isa(CONV_AUTO);
+                break;
+            case 'a': opt.file_A = optarg; break;
+            case 'b': opt.file_B = optarg; break;
+            case 'o': opt.file_C = optarg; break;
+            case 's': opt.segment = atoi(optarg); break;
+            case 'g': generate = 1; break;
+            case 'f': opt.manifest = optarg; break;
+            case 'w': opt.shared = 1; break;
+            case 'c': check = 1; break;
+            case 'H': hwperf = 1; break;
+            case 'r': reps = atoi(optarg); break;
+            case 'u': warmup = atoi(optarg); break;
+            case 'R': results = optarg; break;
+            default:
+                if (my_rank == 0) usage(argv[0]);
+                MPI_Finalize();
+                return 0;
+        }
+    }
+
+    // Νήματα ανά διεργασία (default 1: ίδια συμπεριφορά με το καθαρό MPI)
+    if (nthreads < 1) nthreads = 1;
+    omp_set_num_threads(nthreads);
+
+    // Batch: οι βαθμοί δίνονται από το manifest, όχι από τη γραμμή εντολών
+    if (opt.mode == MODE_BATCH) {
+        if (optind != argc || opt.manifest == NULL) {
+            if (my_rank == 0) usage(argv[0]);
+            MPI_Finalize();
+            return 0;
+        }
+        phase_times_t t;
+        mult_batch(&opt, &t);
+        if (my_rank == 0) {
+            printf("MPI Processes P:        %d\n", comm_sz);
+            if (nthreads > 1) printf("Threads per rank T:     %d\n", nthreads);
+            printf("(i)   Dist Wait Time:   %e sec\n", t.comm);
+            printf("(ii)  Calc Time:        %e sec\n", t.calc);
+            printf("(iii) Reduce Wait Time: %e sec\n", t.reduce);
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    if (optind != argc - 1 || opt.threshold < 1 || opt.segment < 1) {
+        if (my_rank == 0) usage(argv[0]);
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Για όλες τις μηχανές: ακέραιος n >= 0 (N >= 1 συντελεστές) και αποτέλεσμα 2n+1 που χωρά σε int
+    char *end;
+    long deg = strtol(argv[optind], &end, 10);
+    if (end == argv[optind] || *end != '\0' || deg < 0 || deg > (INT_MAX - 1) / 2) {
+        if (my_rank == 0)
+            printf("Error: Polynomial degree n=%s must be an integer in [0, %d].\n", argv[optind], (INT_MAX - 1) / 2);
+        MPI_Finalize();
+        return 0;
+    }
+    n = (int) deg;
+    N = n + 1; // Πλήθος συντελεστών (βαθμός n -> n+1 όροι)
+
+    // Κάθε διεργασία χρειάζεται τουλάχιστον έναν συντελεστή του A (η διανομή
+    // γίνεται με Scatterv, οπότε το N δεν χρειάζεται να διαιρείται με το P)
+    if ((opt.mode == MODE_SCHOOLBOOK || opt.mode == MODE_TILED) && N < comm_sz) {
+        if (my_rank == 0) {
+            printf("Error: Matrix size N=%d is smaller than P=%d.\n", N, comm_sz);
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Το γινόμενο πολυωνύμων βαθμού n έχει βαθμό 2n, άρα μέγεθος 2n+1.
+    int res_size = 2 * n + 1;
+
+    // Δείκτες για τους Global πίνακες (χρήση μόνο από τον Master)
+    int *A = NULL;
+    int *B = NULL;
+    long long *final_C = NULL;
+
+    // Στο streaming τα πολυώνυμα ζουν μόνο στα αρχεία (καμία δέσμευση O(n))
+    int in_memory = (opt.mode != MODE_STREAM);
+
+    // Ο Master δεσμεύει και αρχικοποιεί τα δεδομένα
+    if (my_rank == 0 && in_memory) {
+        A = (int*) malloc(N * sizeof(int));
+        B = (int*) malloc(N * sizeof(int));
+        final_C = (long long*) malloc(res_size * sizeof(long long));
+
+        printf("Master: Initializing polynomials (Degree n=%d, Coeffs N=%d)...\n", n, N);
+        srand(42); // Seed για επαναληψιμότητα των πειραμάτων
+        for (int i = 0; i < N; i++) {
+            A[i] = (rand() % 10) + 1;
+            B[i] = (rand() % 10) + 1;
+        }
+    }
+
+    if (opt.mode == MODE_STREAM && generate) {
+        if (my_rank == 0) printf("Master: Writing %s / %s (Degree n=%d, Coeffs N=%d)...\n",
+                                 opt.file_A, opt.file_B, n, N);
+        if (stream_generate(N, &opt) != 0) {
+            MPI_Finalize();
+            return 0;
+        }
+    }
+
+    /* --- Εκτέλεση της επιλεγμένης μηχανής (warm-up + χρονομετρημένες επαναλήψεις) --- */
+    // Κάθε επανάληψη είναι πλήρης εκτέλεση (διανομή, υπολογισμός, αναγωγή).
+    // Καταγράφονται οι τοπικοί χρόνοι κάθε διεργασίας.
+    bench_t bench;
+    bench_init(&bench, "ex3_1", reps, warmup);
+    int ph_comm = bench_phase(&bench, "comm");
+    int ph_calc = bench_phase(&bench, "calc");
+    int ph_work = bench_phase(&bench, "work");
+    int ph_reduce = bench_phase(&bench, "reduce");
+    int ph_total = bench_phase(&bench, "total");
+
+    // Μετρητές υλικού (-H): μόνο ο πυρήνας συνέλιξης του schoolbook / tiled
+    perf_t pf;
+    perf_init(&pf, hwperf && (opt.mode == MODE_SCHOOLBOOK || opt.mode == MODE_TILED));
+    int pf_conv = perf_region(&pf, "conv");
+
+    phase_times_t t;
+    for (int rep = -bench.warmup; rep < bench.reps; rep++) {
+        if (rep == 0) perf_reset(&pf, pf_conv);
+        if (opt.mode == MODE_STREAM) {
+            if (mult_stream(N, &opt, &t) != 0) {
+                bench_free(&bench);
+                perf_free(&pf);
+                MPI_Finalize();
+                return 0;
+            }
+        } else if (opt.mode == MODE_SCHOOLBOOK) {
+            mult_schoolbook(A, B, N, final_C, opt.shared, &pf, pf_conv, &t);
+        } else if (opt.mode == MODE_TILED) {
+            mult_tiled(A, B, N, final_C, opt.shared, &pf, pf_conv, &t);
+        } else if (opt.mode == MODE_OWNER) {
+            mult_owner(A, B, N, final_C, &t);
+        } else if (opt.mode == MODE_NTT) {
+            mult_ntt(A, B, N, final_C, &t);
+        } else {
+            mult_karatsuba(A, B, N, final_C, &opt, &t);
+        }
+        bench_record(&bench, ph_comm, rep, t.comm);
+        bench_record(&bench, ph_calc, rep, t.calc);
+        bench_record(&bench, ph_work, rep, t.work);
+        bench_record(&bench, ph_reduce, rep, t.reduce);
+        bench_record(&bench, ph_total, rep, t.comm + t.calc + t.reduce);
+    }
+
+    bench_param(&bench, "engine", "%s", mode_name(opt.mode));
+    bench_param(&bench, "n", "%d", n);
+    bench_param(&bench, "T", "%d", nthreads);
+    bench_param(&bench, "shared", "%d", opt.shared);
+    bench_finish(&bench, MPI_COMM_WORLD);
+
+    // Οι χρόνοι της αναφοράς: median (ως προς τις επαναλήψεις) της πιο αργής διεργασίας.
+    // Το σύνολο είναι η median της φάσης "total" (όπως στο CSV / JSON), όχι άθροισμα medians.
+    t.comm = bench.stat[ph_comm].med;
+    t.calc = bench.stat[ph_calc].med;
+    t.reduce = bench.stat[ph_reduce].med;
+
     // Εκτύπωση αποτελεσμάτων από τον Master
     if (my_rank == 0) {
         printf("\n--- RESULTS ---\n");
         printf("Polynomial Degree n: %d (Coeffs N=%d)\n", n, N);
         printf("MPI Processes P:     %d\n", comm_sz);
+        if (nthreads > 1) printf("Threads per rank T:  %d\n", nthreads);
+        printf("Engine:              %s", mode_name(opt.mode));
+        if (opt.mode == MODE_KARATSUBA || opt.mode == MODE_TOOM3) printf(" (threshold=%d)", opt.threshold);
+        if (opt.mode == MODE_TILED) printf(" (%s)", conv_isa_name(conv_get_isa()));
+        if (opt.mode == MODE_STREAM) printf(" (%s x %s -> %s)", opt.file_A, opt.file_B, opt.file_C);
+        if (opt.shared && (opt.mode == MODE_SCHOOLBOOK || opt.mode == MODE_TILED)) printf(" [shared B per node]");
+        printf("\n");
         printf("--------------------------------------\n");
-        printf("(i)   Comm Time (Scatter/Bcast): %e sec\n", t_comm_end - t_start);
-        printf("(ii)  Calc Time:                 %e sec\n", t_calc_end - t_comm_end);
-        printf("(iii) Reduce Time:               %e sec\n", t_reduce_end - t_calc_end);
-        printf("(iv)  Total Parallel Time:       %e sec\n", t_reduce_end - t_start);
+        if (opt.mode == MODE_STREAM)
+            printf("(i)   Comm Time (segment I/O):   %e sec\n", t.comm);
+        else
+            printf("(i)   Comm Time (Scatter/Bcast): %e sec\n", t.comm);
+        printf("(ii)  Calc Time:                 %e sec\n", t.calc);
+        printf("(iii) Reduce Time:               %e sec\n", t.reduce);
+        printf("(iv)  Total Parallel Time:       %e sec\n", bench.stat[ph_total].med);
+        printf("Calc imbalance (max/mean):       %.3f\n", bench.stat[ph_work].imbalance);
         printf("--------------------------------------\n");
+        if (bench.reps > 1 || results) bench_print(&bench);
+        if (results && bench_write(&bench, results) != 0)
+            printf("Warning: cannot write %s (not writable, or a CSV with other columns)\n", results);
 
         // Εκτύπωση διανύσματος μόνο αν είναι μικρό (για επαλήθευση)
-        if (res_size <= 30) {
+        if (res_size <= 30 && in_memory) {
             printf("Final Result C (Degree 2n): \n");
             for (int i = 0; i < res_size; i++) {
-                printf("%d ", final_C[i]);
+                printf("%lld ", final_C[i]);
             }
             printf("\n");
         }
+
+        if (check) {
+            int errors = in_memory ? verify_result(A, B, N, final_C) : stream_verify(N, &opt);
+            if (errors < 0) printf("Verification: SKIPPED (cannot read the stream files)\n");
+            else if (errors == 0) printf("Verification: PASSED (matches serial schoolbook)\n");
+            else printf("Verification: FAILED (%d mismatching coefficients)\n", errors);
+        }
     }
 
-    // Αποδέσμευση μνήμης
-    free(local_A);
-    free(B);
-    free(local_C);
+    // Roofline του πυρήνα (-H): STREAM triad σε όλες τις διεργασίες, μετά η αναφορά
+    perf_stream(&pf, MPI_COMM_WORLD);
+    perf_report(&pf, MPI_COMM_WORLD);
+    perf_free(&pf);
 
+    // Αποδέσμευση μνήμης
+    bench_free(&bench);
     if (my_rank == 0) {
         free(A);
+        free(B);
         free(final_C);
     }
 
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
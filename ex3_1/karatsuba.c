@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "poly.h"
+#include "timer.h"
+
+/* --- Κατάσταση αναδρομής --- */
+// Όλες οι διεργασίες εκτελούν ΤΗΝ ΙΔΙΑ αναδρομή στα πάνω (κατανεμημένα) επίπεδα,
+// οπότε ο μετρητής next_task δίνει την ίδια αρίθμηση υποπροβλημάτων σε όλους.
+// Κάθε φύλλο (task) υπολογίζεται μόνο από τη διεργασία task % size.
+typedef struct {
+    int rank, size;
+    int next_task;     // Επόμενο id υποπροβλήματος (DFS σειρά)
+    int my_tasks;      // Πόσα υποπροβλήματα ανέλαβε αυτή η διεργασία
+    int threshold;     // Όριο μετάβασης σε schoolbook
+    int use_toom;      // Toom-3 στην τοπική αναδρομή
+} kara_ctx_t;
+
+static void kara_rec(const long long *a, const long long *b, int n, long long *c,
+                     kara_ctx_t *ctx, int level);
+
+/* --- Ένα βήμα Karatsuba --- */
+// a = a0 + a1*x^m, b = b0 + b1*x^m
+// a*b = z0 + (z1 - z0 - z2)*x^m + z2*x^(2m), με z1 = (a0+a1)(b0+b1)
+// Ο συνδυασμός είναι ΓΡΑΜΜΙΚΟΣ ως προς τα z0, z1, z2: αν κάθε διεργασία έχει
+// μηδενικά στα υποπροβλήματα που δεν ανέλαβε, το άθροισμα (MPI_SUM) όλων
+// των μερικών αποτελεσμάτων είναι ακριβώς το γινόμενο.
+static void kara_step(const long long *a, const long long *b, int n, long long *c,
+                      kara_ctx_t *ctx, int sub_level) {
+    int m = (n + 1) / 2;   // Μέγεθος χαμηλού μισού
+    int h = n - m;         // Μέγεθος υψηλού μισού (h <= m)
+
+    long long *sa = (long long*) malloc(2 * m * sizeof(long long));
+    long long *sb = sa + m;
+    long long *z0 = (long long*) malloc((2 * m - 1) * sizeof(long long));
+    long long *z1 = (long long*) malloc((2 * m - 1) * sizeof(long long));
+    long long *z2 = (long long*) malloc((2 * h - 1) * sizeof(long long));
+
+    for (int i = 0; i < m; i++) {
+        sa[i] = a[i] + (i < h ? a[m + i] : 0);
+        sb[i] = b[i] + (i < h ? b[m + i] : 0);
+    }
+
+    kara_rec(a, b, m, z0, ctx, sub_level);
+    kara_rec(sa, sb, m, z1, ctx, sub_level);
+    kara_rec(a + m, b + m, h, z2, ctx, sub_level);
+
+    // z1 = z1 - z0 - z2
+    for (int i = 0; i < 2 * m - 1; i++) z1[i] -= z0[i];
+    for (int i = 0; i < 2 * h - 1; i++) z1[i] -= z2[i];
+
+    // Συναρμολόγηση αποτελέσματος (μήκος 2n-1)
+    memset(c, 0, (2 * n - 1) * sizeof(long long));
+    for (int i = 0; i < 2 * m - 1; i++) c[i] += z0[i];
+    for (int i = 0; i < 2 * h - 1; i++) c[2 * m + i] += z2[i];
+    for (int i = 0; i < 2 * m - 1 && m + i < 2 * n - 1; i++) c[m + i] += z1[i];
+
+    free(sa); free(z0); free(z1); free(z2);
+}
+
+/* --- Ένα βήμα Toom-3 (Toom-Cook 3-way) --- */
+// Διάσπαση σε 3 τμήματα μήκους k, αποτίμηση στα σημεία 0, 1, -1, -2, ∞,
+// 5 αναδρομικοί πολλαπλασιασμοί και παρεμβολή (ακολουθία Bodrato).
+// Οι διαιρέσεις με 2 και 3 είναι ακριβείς μόνο στο ΣΥΝΟΛΙΚΟ γινόμενο, γι' αυτό
+// το Toom-3 χρησιμοποιείται μόνο στην τοπική (μη κατανεμημένη) αναδρομή.
+static void toom3_step(const long long *a, const long long *b, int n, long long *c,
+                       kara_ctx_t *ctx) {
+    int k = (n + 2) / 3;
+    int len = 2 * k - 1;
+
+    // Συμπλήρωση με μηδενικά ώστε n = 3k
+    long long *pad = NULL;
+    if (3 * k != n) {
+        pad = (long long*) calloc(6 * k, sizeof(long long));
+        memcpy(pad, a, n * sizeof(long long));
+        memcpy(pad + 3 * k, b, n * sizeof(long long));
+        a = pad;
+        b = pad + 3 * k;
+    }
+    const long long *a0 = a, *a1 = a + k, *a2 = a + 2 * k;
+    const long long *b0 = b, *b1 = b + k, *b2 = b + 2 * k;
+
+    // Αποτιμήσεις στα σημεία 1, -1, -2
+    long long *ev = (long long*) malloc(6 * k * sizeof(long long));
+    long long *ea1 = ev, *eam1 = ev + k, *eam2 = ev + 2 * k;
+    long long *eb1 = ev + 3 * k, *ebm1 = ev + 4 * k, *ebm2 = ev + 5 * k;
+    for (int i = 0; i < k; i++) {
+        ea1[i]  = a0[i] + a1[i] + a2[i];
+        eam1[i] = a0[i] - a1[i] + a2[i];
+        eam2[i] = a0[i] - 2 * a1[i] + 4 * a2[i];
+        eb1[i]  = b0[i] + b1[i] + b2[i];
+        ebm1[i] = b0[i] - b1[i] + b2[i];
+        ebm2[i] = b0[i] - 2 * b1[i] + 4 * b2[i];
+    }
+
+    long long *r = (long long*) malloc(5 * len * sizeof(long long));
+    long long *r0 = r, *r1 = r + len, *rm1 = r + 2 * len, *rm2 = r + 3 * len, *rinf = r + 4 * len;
+    kara_rec(a0, b0, k, r0, ctx, -1);
+    kara_rec(ea1, eb1, k, r1, ctx, -1);
+    kara_rec(eam1, ebm1, k, rm1, ctx, -1);
+    kara_rec(eam2, ebm2, k, rm2, ctx, -1);
+    kara_rec(a2, b2, k, rinf, ctx, -1);
+
+    // Παρεμβολή: r0..r4 γίνονται οι συντελεστές του x^(ik)
+    for (int i = 0; i < len; i++) {
+        long long v0 = r0[i], v1 = r1[i], vm1 = rm1[i], vm2 = rm2[i], v4 = rinf[i];
+        long long t3 = (vm2 - v1) / 3;
+        long long t1 = (v1 - vm1) / 2;
+        long long t2 = vm1 - v0;
+        t3 = (t2 - t3) / 2 + 2 * v4;
+        t2 = t2 + t1 - v4;
+        t1 = t1 - t3;
+        r1[i] = t1; rm1[i] = t2; rm2[i] = t3;
+    }
+
+    memset(c, 0, (2 * n - 1) * sizeof(long long));
+    const long long *parts[5] = { r0, r1, rm1, rm2, rinf };
+    for (int p = 0; p < 5; p++) {
+        for (int i = 0; i < len; i++) {
+            int idx = p * k + i;
+            if (idx < 2 * n - 1) c[idx] += parts[p][i];   // Πέρα από 2n-1 μόνο μηδενικά
+        }
+    }
+
+    free(r); free(ev); free(pad);
+}
+
+/* --- Αναδρομή --- */
+// level > 0: κατανεμημένο επίπεδο (όλες οι διεργασίες συμμετέχουν)
+// level == 0: φύλλο-υποπρόβλημα, το υπολογίζει μόνο ο ιδιοκτήτης του
+// level < 0: τοπική αναδρομή
+static void kara_rec(const long long *a, const long long *b, int n, long long *c,
+                     kara_ctx_t *ctx, int level) {
+    if (level == 0 || (level > 0 && n <= ctx->threshold)) {
+        int task = ctx->next_task++;
+        if (task % ctx->size == ctx->rank) {
+            ctx->my_tasks++;
+            kara_rec(a, b, n, c, ctx, -1);
+        } else {
+            memset(c, 0, (2 * n - 1) * sizeof(long long));
+        }
+        return;
+    }
+
+    if (level < 0 && n <= ctx->threshold) {
+        memset(c, 0, (2 * n - 1) * sizeof(long long));
+        conv_schoolbook(a, n, b, n, c);
+        return;
+    }
+
+    if (level < 0 && ctx->use_toom && n >= 3 * ctx->threshold) {
+        toom3_step(a, b, n, c, ctx);
+    } else {
+        kara_step(a, b, n, c, ctx, level > 0 ? level - 1 : -1);
+    }
+}
+
+void karatsuba_mul(const long long *a, const long long *b, int n, long long *c, int threshold) {
+    kara_ctx_t ctx = { 0, 1, 0, 0, threshold, 0 };
+    kara_rec(a, b, n, c, &ctx, -1);
+}
+
+void toom3_mul(const long long *a, const long long *b, int n, long long *c, int threshold) {
+    kara_ctx_t ctx = { 0, 1, 0, 0, threshold, 1 };
+    kara_rec(a, b, n, c, &ctx, -1);
+}
+
+/* --- Αυτόματη επιλογή κατανεμημένων επιπέδων --- */
+// Το επίπεδο L δίνει 3^L υποπροβλήματα. Θέλουμε τουλάχιστον ~4 ανά διεργασία
+// για καλή ισορροπία φορτίου με round-robin ανάθεση.
+static int auto_levels(int N, int comm_sz, int threshold) {
+    int levels = 0;
+    long tasks = 1;
+    int size = N;
+    while (comm_sz > 1 && tasks < 4L * comm_sz && size > threshold) {
+        levels++;
+        tasks *= 3;
+        size = (size + 1) / 2;
+    }
+    return levels;
+}
+
+/* --- Κατανεμημένος Karatsuba --- */
+// Φάση επικοινωνίας: Bcast των A και B (κάθε διεργασία χρειάζεται και τα δύο
+// για να σχηματίσει τα αθροίσματα a0+a1, b0+b1 των πάνω επιπέδων).
+// Φάση υπολογισμού: κάθε διεργασία υπολογίζει τα δικά της υποπροβλήματα.
+// Φάση συλλογής: MPI_Reduce(SUM) των μερικών γινομένων, όπως στο schoolbook.
+void mult_karatsuba(const int *A, const int *B, int N, long long *final_C,
+                    const mult_opts_t *opt, phase_times_t *t) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+
+    int res_size = 2 * N - 1;
+    int *A_buf = (int*) malloc(N * sizeof(int));
+    int *B_buf = (int*) malloc(N * sizeof(int));
+    if (my_rank == 0) {
+        memcpy(A_buf, A, N * sizeof(int));
+        memcpy(B_buf, B, N * sizeof(int));
+    }
+
+    int levels = (opt->levels >= 0) ? opt->levels : auto_levels(N, comm_sz, opt->threshold);
+
+    double t_start, t_comm_end, t_work_end, t_calc_end, t_reduce_end;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_start);
+
+    MPI_Bcast(A_buf, N, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(B_buf, N, MPI_INT, 0, MPI_COMM_WORLD);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_comm_end);
+
+    long long *a = (long long*) malloc(N * sizeof(long long));
+    long long *b = (long long*) malloc(N * sizeof(long long));
+    for (int i = 0; i < N; i++) {
+        a[i] = A_buf[i];
+        b[i] = B_buf[i];
+    }
+    long long *local_C = (long long*) malloc(res_size * sizeof(long long));
+
+    kara_ctx_t ctx = { my_rank, comm_sz, 0, 0, opt->threshold, opt->mode == MODE_TOOM3 };
+    kara_rec(a, b, N, local_C, &ctx, levels);
+
+    GET_TIME(t_work_end);   // Τοπικός χρόνος, χωρίς την αναμονή στο barrier
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_calc_end);
+
+    printf("Rank %d computed %d of %d Karatsuba subproblems\n", my_rank, ctx.my_tasks, ctx.next_task);
+
+    MPI_Reduce(local_C, final_C, res_size, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    GET_TIME(t_reduce_end);
+
+    t->comm = t_comm_end - t_start;
+    t->calc = t_calc_end - t_comm_end;
+    t->work = t_work_end - t_comm_end;
+    t->reduce = t_reduce_end - t_calc_end;
+
+    free(A_buf); free(B_buf); free(a); free(b); free(local_C);
+}
@@ -0,0 +1,358 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <mpi.h>
+#include "poly.h"
+#include "timer.h"
+
+/* --- NTT-friendly πρώτοι αριθμοί: p = c * 2^k + 1 --- */
+// Ταξινομημένοι κατά μέγιστο μήκος μετασχηματισμού (2^k).
+// Το γινόμενο των τριών (~7e26) καλύπτει κάθε συντελεστή 64-bit.
+#define MAX_PRIMES 3
+static const uint32_t ntt_prime[MAX_PRIMES] = { 2013265921u, 469762049u, 754974721u };
+static const uint32_t ntt_root[MAX_PRIMES]  = { 31u, 3u, 11u };     // Πρωταρχικές ρίζες
+static const int      ntt_log2[MAX_PRIMES]  = { 27, 26, 24 };       // Μέγιστο log2(L)
+
+static uint32_t pow_mod(uint32_t base, uint64_t e, uint32_t p) {
+    uint64_t r = 1, b = base % p;
+    while (e) {
+        if (e & 1) r = r * b % p;
+        b = b * b % p;
+        e >>= 1;
+    }
+    return (uint32_t) r;
+}
+
+/* --- Μπλοκ κατανομή: διεργασία r κατέχει [lo(r), lo(r+1)) --- */
+static int block_lo(int r, int n, int comm_sz) {
+    return (int) ((long long) r * n / comm_sz);
+}
+
+/* --- Τοπικός επαναληπτικός NTT (radix-2, φυσική σειρά εισόδου/εξόδου) --- */
+// w: πίνακας ριζών w^i, i < len/2, όπου w πρωταρχική ρίζα τάξης len.
+static void ntt_local(uint32_t *a, int len, const uint32_t *w, uint32_t p) {
+    // Bit-reversal αναδιάταξη
+    for (int i = 1, j = 0; i < len; i++) {
+        int bit = len >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) { uint32_t tmp = a[i]; a[i] = a[j]; a[j] = tmp; }
+    }
+    // Πεταλούδες
+    for (int m = 2; m <= len; m <<= 1) {
+        int half = m >> 1, step = len / m;
+        for (int s = 0; s < len; s += m) {
+            for (int j = 0; j < half; j++) {
+                uint32_t u = a[s + j];
+                uint32_t v = (uint32_t) ((uint64_t) a[s + j + half] * w[j * step] % p);
+                a[s + j] = (u + v >= p) ? u + v - p : u + v;
+                a[s + j + half] = (u >= v) ? u - v : u + p - v;
+            }
+        }
+    }
+}
+
+// Πίνακας ριζών για μήκος len (inverse: με την αντίστροφη ρίζα)
+static uint32_t *root_table(int len, int q, int inverse) {
+    uint32_t p = ntt_prime[q];
+    uint32_t w = pow_mod(ntt_root[q], (p - 1) / len, p);
+    if (inverse) w = pow_mod(w, p - 2, p);
+    int half = len > 1 ? len / 2 : 1;
+    uint32_t *tab = (uint32_t*) malloc(half * sizeof(uint32_t));
+    uint64_t cur = 1;
+    for (int i = 0; i < half; i++) {
+        tab[i] = (uint32_t) cur;
+        cur = cur * w % p;
+    }
+    return tab;
+}
+
+/* --- Κατανεμημένη αναστροφή (transpose) πινάκων R x C --- */
+// Είσοδος: γραμμές [lo_R(me), lo_R(me+1)) του R x C πίνακα (row-major).
+// Έξοδος:  γραμμές [lo_C(me), lo_C(me+1)) του ανάστροφου C x R πίνακα.
+// Όλοι οι nb πίνακες μεταφέρονται με ΕΝΑ MPI_Alltoallv.
+static void dist_transpose(uint32_t **in, uint32_t **out, int nb, int R, int C,
+                           int my_rank, int comm_sz) {
+    int my_rows = block_lo(my_rank + 1, R, comm_sz) - block_lo(my_rank, R, comm_sz);
+    int my_cols = block_lo(my_rank + 1, C, comm_sz) - block_lo(my_rank, C, comm_sz);
+
+    int *scounts = (int*) malloc(4 * comm_sz * sizeof(int));
+    int *sdispls = scounts + comm_sz, *rcounts = scounts + 2 * comm_sz, *rdispls = scounts + 3 * comm_sz;
+    for (int r = 0; r < comm_sz; r++) {
+        int cols_r = block_lo(r + 1, C, comm_sz) - block_lo(r, C, comm_sz);
+        int rows_r = block_lo(r + 1, R, comm_sz) - block_lo(r, R, comm_sz);
+        scounts[r] = nb * my_rows * cols_r;
+        rcounts[r] = nb * rows_r * my_cols;
+        sdispls[r] = r ? sdispls[r - 1] + scounts[r - 1] : 0;
+        rdispls[r] = r ? rdispls[r - 1] + rcounts[r - 1] : 0;
+    }
+    size_t total = (size_t) nb * my_rows * C;
+    uint32_t *sbuf = (uint32_t*) malloc((total ? total : 1) * sizeof(uint32_t));
+    uint32_t *rbuf = (uint32_t*) malloc(((size_t) nb * my_cols * R + 1) * sizeof(uint32_t));
+
+    // Πακετάρισμα: για κάθε παραλήπτη, το μπλοκ των στηλών του
+    for (int r = 0; r < comm_sz; r++) {
+        int c0 = block_lo(r, C, comm_sz), c1 = block_lo(r + 1, C, comm_sz);
+        uint32_t *dst = sbuf + sdispls[r];
+        for (int b = 0; b < nb; b++)
+            for (int i = 0; i < my_rows; i++)
+                for (int c = c0; c < c1; c++) *dst++ = in[b][(size_t) i * C + c];
+    }
+
+    MPI_Alltoallv(sbuf, scounts, sdispls, MPI_UNSIGNED,
+                  rbuf, rcounts, rdispls, MPI_UNSIGNED, MPI_COMM_WORLD);
+
+    // Ξεπακετάρισμα: μπλοκ από τη διεργασία s -> στήλες [lo_R(s), lo_R(s+1)) της εξόδου
+    for (int s = 0; s < comm_sz; s++) {
+        int r0 = block_lo(s, R, comm_sz), r1 = block_lo(s + 1, R, comm_sz);
+        uint32_t *src = rbuf + rdispls[s];
+        for (int b = 0; b < nb; b++)
+            for (int i = r0; i < r1; i++)
+                for (int c = 0; c < my_cols; c++) out[b][(size_t) c * R + i] = *src++;
+    }
+
+    free(sbuf); free(rbuf); free(scounts);
+}
+
+/* --- Κατανεμημένος NTT πολυωνύμων μέσω CRT --- */
+// Μήκος L = n1 * n2 (δυνάμεις του 2). Ο δείκτης j = j1 + n1*j2 του πολυωνύμου
+// και ο δείκτης k = k2 + n2*k1 του μετασχηματισμού δίνουν (four-step):
+//   X[k2 + n2*k1] = Σ_j1 w_n1^(j1*k1) * w_L^(j1*k2) * Σ_j2 w_n2^(j2*k2) x[j1 + n1*j2]
+// 1. NTT μήκους n2 σε κάθε τοπική γραμμή j1
+// 2. Πολλαπλασιασμός με twiddle w_L^(j1*k2)
+// 3. Αναστροφή (MPI_Alltoallv): κάθε διεργασία κατέχει πλέον γραμμές k2
+// 4. NTT μήκους n1 σε κάθε τοπική γραμμή k2
+// Ο πολλαπλασιασμός σημείο-προς-σημείο γίνεται σε αυτή τη διάταξη και ο
+// αντίστροφος μετασχηματισμός εκτελεί τα ίδια βήματα αντίστροφα.
+void mult_ntt(const int *A, const int *B, int N, long long *final_C, phase_times_t *t) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+
+    int res_size = 2 * N - 1;
+
+    // Μήκος μετασχηματισμού: L >= 2N-1, δύναμη του 2
+    int log_L = 1;
+    while ((1LL << log_L) < res_size) log_L++;
+    int L = 1 << log_L;
+    int n1 = 1 << (log_L / 2);
+    int n2 = L / n1;
+
+    // Πλήθος πρώτων: το γινόμενό τους πρέπει να υπερβαίνει 2*max|C_k|
+    // (προσημασμένη αναπαράσταση). Υπολογίζεται από τον Master.
+    int nprimes = MAX_PRIMES;
+    if (my_rank == 0) {
+        long long max_a = 0, max_b = 0;
+        for (int i = 0; i < N; i++) {
+            long long va = A[i] < 0 ? -(long long) A[i] : A[i];
+            long long vb = B[i] < 0 ? -(long long) B[i] : B[i];
+            if (va > max_a) max_a = va;
+            if (vb > max_b) max_b = vb;
+        }
+        long double bound = 2.0L * max_a * max_b * N + 1.0L;
+        long double prod = 1.0L;
+        for (nprimes = 0; nprimes < MAX_PRIMES && prod <= bound; nprimes++) prod *= ntt_prime[nprimes];
+        if (nprimes == 0) nprimes = 1;
+    }
+
+    double t_start, t_comm_end, t_work_end, t_calc_end, t_reduce_end;
+    double t_tr0, t_tr1, t_transpose = 0.0;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_start);
+
+    MPI_Bcast(&nprimes, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (log_L > ntt_log2[nprimes - 1]) {
+        if (my_rank == 0)
+            printf("Error: NTT length 2^%d exceeds the 2^%d limit of %d prime(s).\n",
+                   log_L, ntt_log2[nprimes - 1], nprimes);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    /* --- Φάση Επικοινωνίας: Scatterv των γραμμών j1 των A και B --- */
+    int row0 = block_lo(my_rank, n1, comm_sz);
+    int my_rows = block_lo(my_rank + 1, n1, comm_sz) - row0;
+    int my_cols = block_lo(my_rank + 1, n2, comm_sz) - block_lo(my_rank, n2, comm_sz);
+    size_t loc_in = (size_t) my_rows * n2;        // Διάταξη γραμμών j1
+    size_t loc_tr = (size_t) my_cols * n1;        // Διάταξη γραμμών k2
+
+    int *scounts = NULL, *displs = NULL, *packed = NULL;
+    if (my_rank == 0) {
+        scounts = (int*) malloc(comm_sz * sizeof(int));
+        displs = (int*) malloc(comm_sz * sizeof(int));
+        packed = (int*) malloc(2 * (size_t) L * sizeof(int));
+        int pos = 0;
+        for (int r = 0; r < comm_sz; r++) {
+            int j0 = block_lo(r, n1, comm_sz), j1_end = block_lo(r + 1, n1, comm_sz);
+            displs[r] = pos;
+            // Πρώτα οι γραμμές του A, μετά του B: x[j1 + n1*j2]
+            for (int which = 0; which < 2; which++) {
+                const int *src = which ? B : A;
+                for (int j1 = j0; j1 < j1_end; j1++)
+                    for (int j2 = 0; j2 < n2; j2++) {
+                        long long idx = j1 + (long long) n1 * j2;
+                        packed[pos++] = (idx < N) ? src[idx] : 0;
+                    }
+            }
+            scounts[r] = pos - displs[r];
+        }
+    }
+    int *local_in = (int*) malloc((2 * loc_in + 1) * sizeof(int));
+    MPI_Scatterv(packed, scounts, displs, MPI_INT,
+                 local_in, (int) (2 * loc_in), MPI_INT, 0, MPI_COMM_WORLD);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_comm_end);
+
+    /* --- Φάση Υπολογισμού --- */
+    // Για κάθε πρώτο q: fa[q], fb[q] στη διάταξη j1 και ta[q], tb[q] στη διάταξη k2
+    uint32_t *fa[MAX_PRIMES], *fb[MAX_PRIMES], *ta[MAX_PRIMES], *tb[MAX_PRIMES];
+    uint32_t *fwd_in[2 * MAX_PRIMES], *fwd_out[2 * MAX_PRIMES];
+    int nb = 0;
+    for (int q = 0; q < nprimes; q++) {
+        uint32_t p = ntt_prime[q];
+        fa[q] = (uint32_t*) malloc((loc_in + 1) * sizeof(uint32_t));
+        fb[q] = (uint32_t*) malloc((loc_in + 1) * sizeof(uint32_t));
+        ta[q] = (uint32_t*) malloc((loc_tr + 1) * sizeof(uint32_t));
+        tb[q] = (uint32_t*) malloc((loc_tr + 1) * sizeof(uint32_t));
+        for (size_t i = 0; i < loc_in; i++) {
+            long long va = local_in[i] % (long long) p, vb = local_in[loc_in + i] % (long long) p;
+            fa[q][i] = (uint32_t) (va < 0 ? va + p : va);
+            fb[q][i] = (uint32_t) (vb < 0 ? vb + p : vb);
+        }
+
+        // Βήματα 1-2: NTT μήκους n2 ανά γραμμή j1 και twiddle w_L^(j1*k2)
+        uint32_t *w2 = root_table(n2, q, 0);
+        uint32_t wL = pow_mod(ntt_root[q], (p - 1) / L, p);
+        for (int i = 0; i < my_rows; i++) {
+            uint32_t base = pow_mod(wL, row0 + i, p);
+            ntt_local(fa[q] + (size_t) i * n2, n2, w2, p);
+            ntt_local(fb[q] + (size_t) i * n2, n2, w2, p);
+            uint64_t tw = 1;
+            for (int k2 = 0; k2 < n2; k2++) {
+                size_t idx = (size_t) i * n2 + k2;
+                fa[q][idx] = (uint32_t) (fa[q][idx] * tw % p);
+                fb[q][idx] = (uint32_t) (fb[q][idx] * tw % p);
+                tw = tw * base % p;
+            }
+        }
+        free(w2);
+        fwd_in[nb] = fa[q]; fwd_out[nb++] = ta[q];
+        fwd_in[nb] = fb[q]; fwd_out[nb++] = tb[q];
+    }
+    free(local_in);
+
+    // Βήμα 3: μία αναστροφή για όλους τους πίνακες (A, B για κάθε πρώτο)
+    GET_TIME(t_tr0);
+    dist_transpose(fwd_in, fwd_out, nb, n1, n2, my_rank, comm_sz);
+    GET_TIME(t_tr1);
+    t_transpose += t_tr1 - t_tr0;
+
+    uint32_t *inv_in[MAX_PRIMES], *inv_out[MAX_PRIMES];
+    for (int q = 0; q < nprimes; q++) {
+        uint32_t p = ntt_prime[q];
+        uint32_t *w1 = root_table(n1, q, 0);
+        uint32_t *w1_inv = root_table(n1, q, 1);
+        for (int c = 0; c < my_cols; c++) {
+            uint32_t *ra = ta[q] + (size_t) c * n1, *rb = tb[q] + (size_t) c * n1;
+            // Βήμα 4: NTT μήκους n1 ανά γραμμή k2
+            ntt_local(ra, n1, w1, p);
+            ntt_local(rb, n1, w1, p);
+            // Πολλαπλασιασμός σημείο-προς-σημείο
+            for (int k1 = 0; k1 < n1; k1++) ra[k1] = (uint32_t) ((uint64_t) ra[k1] * rb[k1] % p);
+            // Αντίστροφο βήμα 4
+            ntt_local(ra, n1, w1_inv, p);
+        }
+        free(w1); free(w1_inv);
+        inv_in[q] = ta[q];
+        inv_out[q] = fa[q];   // Επαναχρησιμοποίηση της μνήμης της διάταξης j1
+    }
+
+    // Αντίστροφο βήμα 3: πίσω στη διάταξη γραμμών j1
+    GET_TIME(t_tr0);
+    dist_transpose(inv_in, inv_out, nprimes, n2, n1, my_rank, comm_sz);
+    GET_TIME(t_tr1);
+    t_transpose += t_tr1 - t_tr0;
+
+    for (int q = 0; q < nprimes; q++) {
+        uint32_t p = ntt_prime[q];
+        uint32_t *w2_inv = root_table(n2, q, 1);
+        uint32_t wL_inv = pow_mod(pow_mod(ntt_root[q], (p - 1) / L, p), p - 2, p);
+        uint32_t L_inv = pow_mod((uint32_t) L, p - 2, p);
+        for (int i = 0; i < my_rows; i++) {
+            uint32_t *row = fa[q] + (size_t) i * n2;
+            // Αντίστροφα βήματα 2 και 1 (και κλιμάκωση με 1/L)
+            uint32_t base = pow_mod(wL_inv, row0 + i, p);
+            uint64_t tw = 1;
+            for (int k2 = 0; k2 < n2; k2++) {
+                row[k2] = (uint32_t) (row[k2] * tw % p);
+                tw = tw * base % p;
+            }
+            ntt_local(row, n2, w2_inv, p);
+            for (int j2 = 0; j2 < n2; j2++) row[j2] = (uint32_t) ((uint64_t) row[j2] * L_inv % p);
+        }
+        free(w2_inv);
+    }
+
+    // Ανασύνθεση με CRT (Garner) στον προσημασμένο ακέραιο συντελεστή
+    uint32_t inv_prefix[MAX_PRIMES];      // (p0*...*p_{q-1})^-1 mod p_q
+    for (int q = 0; q < nprimes; q++) {
+        uint64_t m = 1;
+        for (int r = 0; r < q; r++) m = m * (ntt_prime[r] % ntt_prime[q]) % ntt_prime[q];
+        inv_prefix[q] = pow_mod((uint32_t) m, ntt_prime[q] - 2, ntt_prime[q]);
+    }
+    long long *local_C = (long long*) malloc((loc_in + 1) * sizeof(long long));
+    for (size_t i = 0; i < loc_in; i++) {
+        unsigned __int128 x = fa[0][i], M = ntt_prime[0];
+        for (int q = 1; q < nprimes; q++) {
+            uint32_t p = ntt_prime[q];
+            uint64_t x_mod = (uint64_t) (x % p);
+            uint64_t d = (fa[q][i] + (uint64_t) p - x_mod) % p;
+            uint64_t tq = d * inv_prefix[q] % p;
+            x += (unsigned __int128) tq * M;
+            M *= p;
+        }
+        local_C[i] = (x > M / 2) ? (long long) -(__int128) (M - x) : (long long) x;
+    }
+    for (int q = 0; q < nprimes; q++) { free(fa[q]); free(fb[q]); free(ta[q]); free(tb[q]); }
+
+    GET_TIME(t_work_end);   // Τοπικός χρόνος, χωρίς την αναμονή στο barrier
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_calc_end);
+
+    /* --- Φάση Συλλογής: Gatherv των γραμμών j1 και αναδιάταξη στον Master --- */
+    long long *gathered = NULL;
+    if (my_rank == 0) {
+        gathered = (long long*) malloc((size_t) L * sizeof(long long));
+        for (int r = 0; r < comm_sz; r++) {
+            scounts[r] = (block_lo(r + 1, n1, comm_sz) - block_lo(r, n1, comm_sz)) * n2;
+            displs[r] = block_lo(r, n1, comm_sz) * n2;
+        }
+    }
+    MPI_Gatherv(local_C, (int) loc_in, MPI_LONG_LONG,
+                gathered, scounts, displs, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+
+    if (my_rank == 0) {
+        // Οι γραμμές είναι αποθηκευμένες με σειρά j1: gathered[j1*n2 + j2] = C[j1 + n1*j2]
+        for (int j1 = 0; j1 < n1; j1++)
+            for (int j2 = 0; j2 < n2; j2++) {
+                long long idx = j1 + (long long) n1 * j2;
+                if (idx < res_size) final_C[idx] = gathered[(size_t) j1 * n2 + j2];
+            }
+    }
+
+    GET_TIME(t_reduce_end);
+
+    if (my_rank == 0) {
+        printf("NTT: L=%d (%d x %d), primes=%d, transpose time=%e sec (included in Calc)\n",
+               L, n1, n2, nprimes, t_transpose);
+    }
+
+    t->comm = t_comm_end - t_start;
+    t->calc = t_calc_end - t_comm_end;
+    t->work = t_work_end - t_comm_end;
+    t->reduce = t_reduce_end - t_calc_end;
+
+    free(local_C); free(gathered); free(packed); free(scounts); free(displs);
+}
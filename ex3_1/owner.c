@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "poly.h"
+#include "timer.h"
+
+/* --- Εργασία για τον συντελεστή C[k] --- */
+// C[k] = Σ A[i]*B[k-i] για max(0, k-N+1) <= i <= min(k, N-1)
+static long long terms(long long k, int N) {
+    long long lo = k - (N - 1) > 0 ? k - (N - 1) : 0;
+    long long hi = k < N - 1 ? k : N - 1;
+    return hi - lo + 1;
+}
+
+/* --- Διαμέριση της εξόδου ανά εργασία --- */
+// Οι συντελεστές στη μέση του C έχουν N όρους, στα άκρα μόνο 1, οπότε
+// ισομερής διαμέριση των 2N-1 δεικτών δίνει άνιση κατανομή φορτίου.
+// Κόβουμε με βάση το προθεματικό άθροισμα των όρων (συνολικά N^2).
+static void owner_partition(int N, int comm_sz, int *cut) {
+    int res_size = 2 * N - 1;
+    long long total = (long long) N * N, acc = 0;
+    int k = 0;
+    cut[0] = 0;
+    for (int r = 1; r < comm_sz; r++) {
+        long long target = total * r / comm_sz;
+        while (k < res_size && acc + terms(k, N) <= target) acc += terms(k++, N);
+        cut[r] = k;
+    }
+    cut[comm_sz] = res_size;
+}
+
+/* --- Owner-computes: κάθε διεργασία κατέχει ένα συνεχές τμήμα του C --- */
+// Η διεργασία με τμήμα [c0, c1) χρειάζεται μόνο τα A[i], B[j] με i, j στο
+// παράθυρο [max(0, c0-N+1), min(N, c1)). Δεν υπάρχει πλήρες local_C ούτε
+// MPI_Reduce: το αποτέλεσμα συναρμολογείται με MPI_Gatherv.
+void mult_owner(const int *A, const int *B, int N, long long *final_C, phase_times_t *t) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+
+    int *cut = (int*) malloc((comm_sz + 1) * sizeof(int));
+    owner_partition(N, comm_sz, cut);
+
+    int c0 = cut[my_rank], c1 = cut[my_rank + 1];
+    int w0 = c0 - (N - 1) > 0 ? c0 - (N - 1) : 0;   // Αρχή παραθύρου εισόδου
+    int w1 = c1 < N ? c1 : N;                       // Τέλος παραθύρου (exclusive)
+    int win = w1 > w0 ? w1 - w0 : 0;
+
+    int *win_A = (int*) malloc((win + 1) * sizeof(int));
+    int *win_B = (int*) malloc((win + 1) * sizeof(int));
+    long long *local_C = (long long*) calloc(c1 - c0 + 1, sizeof(long long));
+
+    double t_start, t_comm_end, t_work_end, t_calc_end, t_reduce_end;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_start);
+
+    /* --- Φάση Επικοινωνίας: αποστολή μόνο των παραθύρων --- */
+    // Τα παράθυρα γειτονικών διεργασιών επικαλύπτονται, οπότε χρησιμοποιούμε
+    // point-to-point αντί για MPI_Scatterv (που δεν επιτρέπει επικάλυψη).
+    if (my_rank == 0) {
+        MPI_Request *reqs = (MPI_Request*) malloc(2 * comm_sz * sizeof(MPI_Request));
+        int nreq = 0;
+        for (int r = 1; r < comm_sz; r++) {
+            int r0 = cut[r] - (N - 1) > 0 ? cut[r] - (N - 1) : 0;
+            int r1 = cut[r + 1] < N ? cut[r + 1] : N;
+            if (r1 <= r0) continue;
+            MPI_Isend(A + r0, r1 - r0, MPI_INT, r, 0, MPI_COMM_WORLD, &reqs[nreq++]);
+            MPI_Isend(B + r0, r1 - r0, MPI_INT, r, 1, MPI_COMM_WORLD, &reqs[nreq++]);
+        }
+        if (win > 0) {
+            memcpy(win_A, A + w0, win * sizeof(int));
+            memcpy(win_B, B + w0, win * sizeof(int));
+        }
+        MPI_Waitall(nreq, reqs, MPI_STATUSES_IGNORE);
+        free(reqs);
+    } else if (win > 0) {
+        MPI_Recv(win_A, win, MPI_INT, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        MPI_Recv(win_B, win, MPI_INT, 0, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_comm_end);
+
+    /* --- Φάση Υπολογισμού --- */
+    // Ίδιος βρόχος με το schoolbook, περιορισμένος σε j ώστε c0 <= i+j < c1
+    for (int i = w0; i < w1; i++) {
+        long long a = win_A[i - w0];
+        int j_lo = c0 - i > w0 ? c0 - i : w0;
+        int j_hi = c1 - i < w1 ? c1 - i : w1;
+        for (int j = j_lo; j < j_hi; j++) {
+            local_C[i + j - c0] += a * win_B[j - w0];
+        }
+    }
+
+    GET_TIME(t_work_end);   // Τοπικός χρόνος, χωρίς την αναμονή στο barrier
+    MPI_Barrier(MPI_COMM_WORLD);
+    GET_TIME(t_calc_end);
+
+    /* --- Φάση Συλλογής: MPI_Gatherv των τμημάτων (χωρίς Reduce) --- */
+    int *counts = NULL;
+    if (my_rank == 0) {
+        counts = (int*) malloc(comm_sz * sizeof(int));
+        for (int r = 0; r < comm_sz; r++) counts[r] = cut[r + 1] - cut[r];
+    }
+    MPI_Gatherv(local_C, c1 - c0, MPI_LONG_LONG, final_C, counts, cut, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+
+    GET_TIME(t_reduce_end);
+
+    // Μνήμη ανά διεργασία (σε int): παράθυρα A, B και τμήμα του C (int64 = 2 int)
+    long long my_words = 2LL * win + 2LL * (c1 - c0), max_words = 0;
+    MPI_Reduce(&my_words, &max_words, 1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+    if (my_rank == 0) {
+        printf("Owner: max per-rank ints = %lld (schoolbook: %lld)\n",
+               max_words, (long long) N / comm_sz + N + (2LL * N - 1));
+    }
+
+    t->comm = t_comm_end - t_start;
+    t->calc = t_calc_end - t_comm_end;
+    t->work = t_work_end - t_comm_end;
+    t->reduce = t_reduce_end - t_calc_end;
+
+    free(win_A); free(win_B); free(local_C); free(cut); free(counts);
+}
@@ -0,0 +1,118 @@
+/* File:     poly.h
+ *
+ * Purpose:  Κοινές δηλώσεις για τις μηχανές πολλαπλασιασμού πολυωνύμων
+ *           του ex3_1 (schoolbook, Karatsuba/Toom-3, NTT,
+ *           owner-computes, tiled, streaming, batch) και της κοινόχρηστης
+ *           μνήμης κόμβου.
+ *
+ * Σύμβαση: Τα A, B (N συντελεστές) είναι έγκυρα μόνο στον Master (rank 0).
+ *          Το final_C (2N-1 συντελεστές, int64) γράφεται μόνο στον Master.
+ */
+#ifndef _POLY_H_
+#define _POLY_H_
+
+#include <mpi.h>
+
+/* Hybrid MPI + OpenMP: χωρίς -fopenmp ο κώδικας τρέχει με ένα νήμα */
+#ifdef _OPENMP
+#include <omp.h>
+#elif !defined(_OMP_STUBS_)
+#define _OMP_STUBS_   // Και στο perf.h: ορίζονται μία φορά, όποια σειρά κι αν έχουν τα #include
+static inline int omp_get_thread_num(void) { return 0; }
+static inline int omp_get_num_threads(void) { return 1; }
+static inline int omp_get_max_threads(void) { return 1; }
+static inline void omp_set_num_threads(int n) { (void) n; }
+#endif
+
+/* Διαθέσιμες μηχανές πολλαπλασιασμού */
+typedef enum {
+    MODE_SCHOOLBOOK = 0,   // Αρχικός O(N^2) αλγόριθμος (Scatter/Bcast/Reduce)
+    MODE_KARATSUBA,        // Αναδρομικός Karatsuba O(N^1.585)
+    MODE_TOOM3,            // Karatsuba στα κατανεμημένα επίπεδα, Toom-3 τοπικά
+    MODE_NTT,              // Κατανεμημένος NTT O(N log N) με CRT
+    MODE_OWNER,            // Schoolbook, κάθε διεργασία κατέχει τμήμα του C
+    MODE_TILED,            // Schoolbook διανομή, tiled/SIMD πυρήνας σε int64
+    MODE_STREAM,           // Out-of-core: τμήματα από/προς αρχεία, overlap-add
+    MODE_BATCH             // Πολλά ζεύγη (manifest) με pipelined διανομή
+} mult_mode_t;
+
+/* Παράμετροι εκτέλεσης (από τη γραμμή εντολών) */
+typedef struct {
+    mult_mode_t mode;
+    int threshold;         // Κάτω από αυτό το μέγεθος -> schoolbook
+    int levels;            // Κατανεμημένα επίπεδα αναδρομής (-1 = αυτόματα)
+    const char *file_A;    // Streaming: αρχεία συντελεστών (A, B: int32, C: int64)
+    const char *file_B;
+    const char *file_C;
+    int segment;           // Streaming: συντελεστές ανά τμήμα
+    const char *manifest;  // Batch: αρχείο με ένα ζεύγος ανά γραμμή
+    int shared;            // Schoolbook/tiled: ένα αντίγραφο του B ανά κόμβο
+} mult_opts_t;
+
+/* Χρόνοι φάσεων (ίδιοι με την αρχική αναφορά) */
+typedef struct {
+    double comm;           // Διανομή δεδομένων
+    double calc;           // Υπολογισμός
+    double work;           // Υπολογισμός της διεργασίας χωρίς την αναμονή στο barrier (ανισορροπία)
+    double reduce;         // Συλλογή αποτελέσματος
+} phase_times_t;
+
+/* --- conv.c: Τοπικοί πυρήνες συνέλιξης --- */
+
+// c[i+j] += a[i] * b[j], c μήκους na+nb-1 (ΔΕΝ μηδενίζεται)
+void conv_schoolbook(const long long *a, int na, const long long *b, int nb, long long *c);
+
+// Σύνολο εντολών του tiled πυρήνα (επιλέγεται κατά την εκτέλεση)
+typedef enum { CONV_AUTO = 0, CONV_SCALAR, CONV_AVX2, CONV_AVX512 } conv_isa_t;
+
+conv_isa_t conv_detect_isa(void);
+void conv_set_isa(conv_isa_t isa);      // CONV_AUTO = το καλύτερο διαθέσιμο
+conv_isa_t conv_get_isa(void);
+const char *conv_isa_name(conv_isa_t isa);
+
+// Ίδιο αποτέλεσμα με το conv_schoolbook, είσοδοι int, συσσώρευση σε int64
+void conv_tiled(const int *a, int na, const int *b, int nb, long long *c);
+
+/* --- karatsuba.c --- */
+
+// Τοπικός (σειριακός) πολλαπλασιασμός δύο πολυωνύμων n όρων, c μήκους 2n-1
+void karatsuba_mul(const long long *a, const long long *b, int n, long long *c, int threshold);
+void toom3_mul(const long long *a, const long long *b, int n, long long *c, int threshold);
+
+void mult_karatsuba(const int *A, const int *B, int N, long long *final_C,
+                    const mult_opts_t *opt, phase_times_t *t);
+
+/* --- ntt.c --- */
+
+void mult_ntt(const int *A, const int *B, int N, long long *final_C, phase_times_t *t);
+
+/* --- owner.c --- */
+
+void mult_owner(const int *A, const int *B, int N, long long *final_C, phase_times_t *t);
+
+/* --- stream.c --- */
+// Επιστρέφουν -1 (σε όλες τις διεργασίες) αν κάποιο αρχείο δεν ανοίγει ή είναι μικρό.
+
+int stream_generate(int N, const mult_opts_t *opt);
+int mult_stream(int N, const mult_opts_t *opt, phase_times_t *t);
+int stream_verify(int N, const mult_opts_t *opt);
+
+/* --- shm.c: Ένα αντίγραφο ανά κόμβο (MPI-3 shared windows) --- */
+
+typedef struct {
+    MPI_Comm node;         // Διεργασίες του ίδιου κόμβου
+    MPI_Comm leaders;      // Node rank 0 κάθε κόμβου (αλλιώς MPI_COMM_NULL)
+    int node_rank, node_size, nnodes;
+    MPI_Win win;
+} shm_buf_t;
+
+// Broadcast των N ακεραίων του Master σε ένα κοινόχρηστο αντίγραφο ανά κόμβο.
+// Επιστρέφει δείκτη (μόνο για ανάγνωση) στο αντίγραφο του κόμβου.
+int *shm_bcast_int(const int *root_buf, int N, shm_buf_t *s);
+void shm_free(shm_buf_t *s);
+
+/* --- batch.c --- */
+
+void mult_batch(const mult_opts_t *opt, phase_times_t *t);
+
+#endif
@@ -44,8 +44,8 @@ for n in $DEGREES; do
     echo "------------------------------------------------------------------" >> $OUTPUT_FILE
     
     for p in $PROCESSES; do
-        # Safety Check: Διαιρετότητα
-        if (( N % p != 0 )); then
+        # Safety Check: τουλάχιστον ένας συντελεστής ανά διεργασία
+        if (( N < p )); then
             continue
         fi
 
@@ -0,0 +1,65 @@
+#!/bin/bash
+
+# --- Hybrid MPI + OpenMP Πειράματα ---
+# Ίδιος συνολικός αριθμός πυρήνων (4 ανά κόμβο), διαφορετικός συνδυασμός
+# διεργασιών ανά κόμβο (RPN) x νημάτων ανά διεργασία (T):
+#   4x1 (καθαρό MPI), 2x2, 1x4 (μία διεργασία ανά κόμβο)
+
+DEGREES="31999 102399 204799"
+NODES="1 2 4 8"
+LAYOUTS="4x1 2x2 1x4"
+
+OUTPUT_FILE="results_ex3_1_hybrid.txt"
+MACHINES_FILE="machines"
+
+# --- Compile ---
+echo "--- Compiling Project ---"
+make clean
+make
+
+if [ ! -f ./ex3_1 ]; then
+    echo "❌ Error: Compilation failed!"
+    exit 1
+fi
+
+# --- Header ---
+echo "==================================================================" > $OUTPUT_FILE
+echo " EXPERIMENT 3.1 HYBRID (MPI x OpenMP) DATA COLLECTION" >> $OUTPUT_FILE
+echo " Degrees: $DEGREES | Nodes: $NODES | Layouts (RPN x T): $LAYOUTS" >> $OUTPUT_FILE
+echo " Date: $(date)" >> $OUTPUT_FILE
+echo "==================================================================" >> $OUTPUT_FILE
+echo "" >> $OUTPUT_FILE
+
+# --- Loops ---
+echo "🚀 Starting Experiments ..."
+
+for n in $DEGREES; do
+    N=$((n+1))
+    echo "------------------------------------------------------------------" >> $OUTPUT_FILE
+    echo ">>> POLYNOMIAL DEGREE n = $n (Size N=$N) <<<" >> $OUTPUT_FILE
+    echo "------------------------------------------------------------------" >> $OUTPUT_FILE
+
+    for nodes in $NODES; do
+        for layout in $LAYOUTS; do
+            rpn=${layout%x*}
+            t=${layout#*x}
+            p=$((nodes * rpn))
+
+            # Safety Check: τουλάχιστον ένας συντελεστής ανά διεργασία
+            if (( N < p )); then
+                continue
+            fi
+
+            echo "   Running: n=$n | Nodes=$nodes | RPN=$rpn | T=$t"
+            echo "   --- Nodes=$nodes | P=$p (RPN=$rpn) | T=$t ---" >> $OUTPUT_FILE
+
+            OMP_NUM_THREADS=$t OMP_PROC_BIND=close \
+                mpiexec -f $MACHINES_FILE -ppn $rpn -n $p ./ex3_1 -t $t $n >> $OUTPUT_FILE
+
+            echo "   ---------------------" >> $OUTPUT_FILE
+        done
+    done
+done
+
+echo "✅ All experiments finished!"
+echo "📄 Results saved in: $OUTPUT_FILE"
@@ -0,0 +1,54 @@
+#include <string.h>
+#include <mpi.h>
+#include "poly.h"
+
+/* ======================================================
+   Κοινόχρηστη μνήμη κόμβου (MPI-3 shared windows)
+   ======================================================
+   Αντί για ένα αντίγραφο του B ανά διεργασία, κρατάμε ΕΝΑ ανά κόμβο:
+   - node:    οι διεργασίες του ίδιου κόμβου (MPI_Comm_split_type SHARED)
+   - leaders: μία διεργασία ανά κόμβο (node rank 0). Ο world rank 0 είναι
+              πάντα leader με leader rank 0, άρα ρίζα του inter-node Bcast.
+   Μόνο οι leaders συμμετέχουν στο Bcast. Οι υπόλοιποι διαβάζουν το B
+   απευθείας από το παράθυρο του leader τους. */
+
+int *shm_bcast_int(const int *root_buf, int N, shm_buf_t *s) {
+    int my_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, my_rank, MPI_INFO_NULL, &s->node);
+    MPI_Comm_rank(s->node, &s->node_rank);
+    MPI_Comm_size(s->node, &s->node_size);
+    MPI_Comm_split(MPI_COMM_WORLD, s->node_rank == 0 ? 0 : MPI_UNDEFINED, my_rank, &s->leaders);
+
+    // Ο leader δεσμεύει όλο το τμήμα, οι υπόλοιποι 0 bytes και παίρνουν τη διεύθυνσή του
+    int *buf;
+    MPI_Aint size = s->node_rank == 0 ? (MPI_Aint) N * sizeof(int) : 0;
+    MPI_Win_allocate_shared(size, sizeof(int), MPI_INFO_NULL, s->node, &buf, &s->win);
+    if (s->node_rank != 0) {
+        MPI_Aint qsize;
+        int disp;
+        MPI_Win_shared_query(s->win, 0, &qsize, &disp, &buf);
+    }
+
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, s->win);
+    if (s->node_rank == 0) {
+        if (my_rank == 0) memcpy(buf, root_buf, N * sizeof(int));
+        MPI_Bcast(buf, N, MPI_INT, 0, s->leaders);
+    }
+    // Ορατότητα των εγγραφών του leader σε όλο τον κόμβο
+    MPI_Win_sync(s->win);
+    MPI_Barrier(s->node);
+    MPI_Win_sync(s->win);
+
+    if (s->leaders != MPI_COMM_NULL) MPI_Comm_size(s->leaders, &s->nnodes);
+    MPI_Bcast(&s->nnodes, 1, MPI_INT, 0, s->node);
+    return buf;
+}
+
+void shm_free(shm_buf_t *s) {
+    MPI_Win_unlock_all(s->win);
+    MPI_Win_free(&s->win);
+    if (s->leaders != MPI_COMM_NULL) MPI_Comm_free(&s->leaders);
+    MPI_Comm_free(&s->node);
+}
@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "poly.h"
+#include "timer.h"
+
+/* --- Αρχεία συντελεστών --- */
+// A, B: N x int32 (δυαδικά, σειρά x^0 .. x^n)
+// C:    (2N-1) x int64
+
+/* --- Άνοιγμα αρχείου --- */
+// Το MPI_File_open είναι συλλογικό και επιστρέφει τον ίδιο κωδικό σε όλες τις
+// διεργασίες του comm, άρα όλες σταματούν μαζί. Μήνυμα μόνο από τον Master.
+static int stream_open(MPI_Comm comm, const char *path, int amode, MPI_File *fh) {
+    if (MPI_File_open(comm, path, amode, MPI_INFO_NULL, fh) == MPI_SUCCESS) return 0;
+    int my_rank;
+    MPI_Comm_rank(comm, &my_rank);
+    if (my_rank == 0) printf("Error: cannot open %s\n", path);
+    return -1;
+}
+
+/* --- Δημιουργία αρχείων εισόδου (τμηματικά) --- */
+// Ίδια ακολουθία rand() με τη γεννήτρια του ex3_1 (A[i], B[i] εναλλάξ),
+// αλλά ο Master κρατά στη μνήμη μόνο ένα τμήμα των segment συντελεστών.
+int stream_generate(int N, const mult_opts_t *opt) {
+    int my_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+    MPI_File fa, fb;
+    if (stream_open(MPI_COMM_WORLD, opt->file_A, MPI_MODE_CREATE | MPI_MODE_WRONLY, &fa) != 0) return -1;
+    if (stream_open(MPI_COMM_WORLD, opt->file_B, MPI_MODE_CREATE | MPI_MODE_WRONLY, &fb) != 0) {
+        MPI_File_close(&fa);
+        return -1;
+    }
+    MPI_File_set_size(fa, (MPI_Offset) N * sizeof(int));
+    MPI_File_set_size(fb, (MPI_Offset) N * sizeof(int));
+
+    if (my_rank == 0) {
+        int S = opt->segment;
+        int *seg_A = (int*) malloc(S * sizeof(int));
+        int *seg_B = (int*) malloc(S * sizeof(int));
+        srand(42); // Seed για επαναληψιμότητα των πειραμάτων
+        for (int s0 = 0; s0 < N; s0 += S) {
+            int len = (N - s0 < S) ? N - s0 : S;
+            for (int i = 0; i < len; i++) {
+                seg_A[i] = (rand() % 10) + 1;
+                seg_B[i] = (rand() % 10) + 1;
+            }
+            MPI_File_write_at(fa, (MPI_Offset) s0 * sizeof(int), seg_A, len, MPI_INT, MPI_STATUS_IGNORE);
+            MPI_File_write_at(fb, (MPI_Offset) s0 * sizeof(int), seg_B, len, MPI_INT, MPI_STATUS_IGNORE);
+        }
+        free(seg_A); free(seg_B);
+    }
+
+    MPI_File_close(&fa);
+    MPI_File_close(&fb);
+    return 0;
+}
+
+/* --- Κατάσταση του Master για το overlap-add --- */
+typedef struct {
+    MPI_File fc;
+    int S, res_size;
+    long long *carry;    // Υψηλό μισό της προηγούμενης διαγωνίου (S όροι)
+    long long *out;      // Τμήμα εξόδου προς εγγραφή (S όροι)
+} overlap_add_t;
+
+// Η διαγώνιος d = p + q συνεισφέρει D_d[0..S) στο τμήμα d του C και
+// D_d[S..2S-1) στο τμήμα d+1. Μόλις ολοκληρωθεί η διαγώνιος d, το τμήμα d
+// είναι τελικό και γράφεται στον δίσκο.
+static void overlap_add(overlap_add_t *st, int d, const long long *D) {
+    int S = st->S;
+    for (int i = 0; i < S; i++) st->out[i] = D[i] + st->carry[i];
+    for (int i = 0; i < S - 1; i++) st->carry[i] = D[S + i];
+    st->carry[S - 1] = 0;
+
+    long long first = (long long) d * S;
+    long long len = st->res_size - first < S ? st->res_size - first : S;
+    if (len > 0)
+        MPI_File_write_at(st->fc, (MPI_Offset) first * sizeof(long long), st->out, (int) len,
+                          MPI_LONG_LONG, MPI_STATUS_IGNORE);
+}
+
+/* --- Streaming πολλαπλασιασμός (out-of-core) --- */
+// A = Σ_p A_p x^(pS), B = Σ_q B_q x^(qS)  =>  C = Σ_d D_d x^(dS), D_d = Σ_{p+q=d} A_p*B_q
+// Τα ζεύγη (p, q) μοιράζονται round-robin στις διεργασίες με έναν καθολικό
+// μετρητή. Κάθε διεργασία διαβάζει μόνη της τα τμήματα A_p, B_q που χρειάζεται
+// και συνεισφέρει ένα μερικό D_d. Το MPI_Ireduce της διαγωνίου d επικαλύπτεται
+// με τον υπολογισμό της d+1 (δύο buffers). Η μνήμη ανά διεργασία είναι O(S).
+int mult_stream(int N, const mult_opts_t *opt, phase_times_t *t) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+
+    int S = opt->segment;
+    int nseg = (N + S - 1) / S;
+    int ndiag = 2 * nseg - 1;
+    int dlen = 2 * S - 1;
+
+    MPI_File fa, fb;
+    if (stream_open(MPI_COMM_WORLD, opt->file_A, MPI_MODE_RDONLY, &fa) != 0) return -1;
+    if (stream_open(MPI_COMM_WORLD, opt->file_B, MPI_MODE_RDONLY, &fb) != 0) {
+        MPI_File_close(&fa);
+        return -1;
+    }
+
+    MPI_Offset size_A, size_B;
+    MPI_File_get_size(fa, &size_A);
+    MPI_File_get_size(fb, &size_B);
+    if (size_A < (MPI_Offset) N * (MPI_Offset) sizeof(int) || size_B < (MPI_Offset) N * (MPI_Offset) sizeof(int)) {
+        if (my_rank == 0)
+            printf("Error: %s / %s hold fewer than N=%d coefficients (use -g to create them).\n",
+                   opt->file_A, opt->file_B, N);
+        MPI_File_close(&fa);
+        MPI_File_close(&fb);
+        return -1;
+    }
+
+    overlap_add_t st;
+    st.S = S;
+    st.res_size = 2 * N - 1;
+    if (stream_open(MPI_COMM_WORLD, opt->file_C, MPI_MODE_CREATE | MPI_MODE_WRONLY, &st.fc) != 0) {
+        MPI_File_close(&fa);
+        MPI_File_close(&fb);
+        return -1;
+    }
+    MPI_File_set_size(st.fc, (MPI_Offset) st.res_size * sizeof(long long));
+
+    int *seg_A = (int*) malloc(S * sizeof(int));
+    int *seg_B = (int*) malloc(S * sizeof(int));
+    long long *D[2], *sum_D[2] = { NULL, NULL };
+    MPI_Request req[2] = { MPI_REQUEST_NULL, MPI_REQUEST_NULL };
+    int pending[2] = { -1, -1 };   // Ποια διαγώνιος βρίσκεται σε κάθε buffer
+    for (int b = 0; b < 2; b++) {
+        D[b] = (long long*) malloc(dlen * sizeof(long long));
+        if (my_rank == 0) sum_D[b] = (long long*) malloc(dlen * sizeof(long long));
+    }
+    if (my_rank == 0) {
+        st.carry = (long long*) calloc(S, sizeof(long long));
+        st.out = (long long*) malloc(S * sizeof(long long));
+    }
+
+    double t_io = 0.0, t_calc = 0.0, t_reduce = 0.0, t0, t1;
+    long long bytes_read = 0;
+    int loaded_p = -1, loaded_q = -1;   // Αποφυγή επαναληπτικής ανάγνωσης του ίδιου τμήματος
+    long long task = 0;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    for (int d = 0; d < ndiag; d++) {
+        int b = d & 1;
+
+        // Ολοκλήρωση της διαγωνίου d-2 πριν επαναχρησιμοποιηθεί ο buffer
+        GET_TIME(t0);
+        if (pending[b] >= 0) {
+            MPI_Wait(&req[b], MPI_STATUS_IGNORE);
+            if (my_rank == 0) overlap_add(&st, pending[b], sum_D[b]);
+            pending[b] = -1;
+        }
+        GET_TIME(t1);
+        t_reduce += t1 - t0;
+
+        memset(D[b], 0, dlen * sizeof(long long));
+        int p_lo = d - (nseg - 1) > 0 ? d - (nseg - 1) : 0;
+        int p_hi = d < nseg - 1 ? d : nseg - 1;
+
+        for (int p = p_lo; p <= p_hi; p++, task++) {
+            if (task % comm_sz != my_rank) continue;
+            int q = d - p;
+            int len_A = (N - p * S < S) ? N - p * S : S;
+            int len_B = (N - q * S < S) ? N - q * S : S;
+
+            GET_TIME(t0);
+            if (p != loaded_p) {
+                MPI_File_read_at(fa, (MPI_Offset) p * S * sizeof(int), seg_A, len_A, MPI_INT, MPI_STATUS_IGNORE);
+                bytes_read += (long long) len_A * sizeof(int);
+                loaded_p = p;
+            }
+            if (q != loaded_q) {
+                MPI_File_read_at(fb, (MPI_Offset) q * S * sizeof(int), seg_B, len_B, MPI_INT, MPI_STATUS_IGNORE);
+                bytes_read += (long long) len_B * sizeof(int);
+                loaded_q = q;
+            }
+            GET_TIME(t1);
+            t_io += t1 - t0;
+
+            conv_tiled(seg_A, len_A, seg_B, len_B, D[b]);
+            GET_TIME(t0);
+            t_calc += t0 - t1;
+        }
+
+        MPI_Ireduce(D[b], sum_D[b], dlen, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD, &req[b]);
+        pending[b] = d;
+    }
+
+    // Ολοκλήρωση των δύο τελευταίων διαγωνίων (με τη σειρά) και της ουράς
+    GET_TIME(t0);
+    for (int d = ndiag - 2; d < ndiag; d++) {
+        if (d < 0) continue;
+        int b = d & 1;
+        MPI_Wait(&req[b], MPI_STATUS_IGNORE);
+        if (my_rank == 0) overlap_add(&st, d, sum_D[b]);
+    }
+    if (my_rank == 0) {
+        // Τμήμα ndiag: μόνο το υψηλό μισό της τελευταίας διαγωνίου
+        memset(D[0], 0, dlen * sizeof(long long));
+        overlap_add(&st, ndiag, D[0]);
+    }
+    MPI_File_close(&st.fc);
+    GET_TIME(t1);
+    t_reduce += t1 - t0;
+
+    MPI_File_close(&fa);
+    MPI_File_close(&fb);
+
+    long long total_read = 0;
+    MPI_Reduce(&bytes_read, &total_read, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (my_rank == 0) {
+        printf("Stream: segment=%d, segments=%d, pairs=%lld, bytes read (all ranks)=%lld\n",
+               S, nseg, task, total_read);
+        printf("Stream: per-rank buffers = %lld bytes (independent of n)\n",
+               2LL * S * sizeof(int) + 4LL * dlen * sizeof(long long) + 2LL * S * sizeof(long long));
+    }
+
+    t->comm = t_io;
+    t->calc = t_calc;
+    t->work = t_calc;
+    t->reduce = t_reduce;
+
+    free(seg_A); free(seg_B);
+    for (int b = 0; b < 2; b++) { free(D[b]); free(sum_D[b]); }
+    if (my_rank == 0) { free(st.carry); free(st.out); }
+    return 0;
+}
+
+/* --- Επαλήθευση από τα αρχεία (μόνο για μικρά n: φορτώνει όλα στη μνήμη) --- */
+// Επιστρέφει το πλήθος των λάθος συντελεστών, ή -1 αν κάποιο αρχείο δεν ανοίγει
+int stream_verify(int N, const mult_opts_t *opt) {
+    int res_size = 2 * N - 1;
+    int *A = (int*) malloc(N * sizeof(int));
+    int *B = (int*) malloc(N * sizeof(int));
+    long long *C = (long long*) malloc(res_size * sizeof(long long));
+    long long *ref = (long long*) calloc(res_size, sizeof(long long));
+
+    // Αρχείο που δεν ανοίγει: -1 (μήνυμα από το stream_open)
+    const char *path[3] = { opt->file_A, opt->file_B, opt->file_C };
+    void *buf[3] = { A, B, C };
+    int len[3] = { N, N, res_size };
+    MPI_Datatype type[3] = { MPI_INT, MPI_INT, MPI_LONG_LONG };
+    for (int f = 0; f < 3; f++) {
+        MPI_File fh;
+        if (stream_open(MPI_COMM_SELF, path[f], MPI_MODE_RDONLY, &fh) != 0) {
+            free(A); free(B); free(C); free(ref);
+            return -1;
+        }
+        MPI_File_read_at(fh, 0, buf[f], len[f], type[f], MPI_STATUS_IGNORE);
+        MPI_File_close(&fh);
+    }
+
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            ref[i + j] += (long long) A[i] * B[j];
+
+    int errors = 0;
+    for (int i = 0; i < res_size; i++) if (ref[i] != C[i]) errors++;
+    free(A); free(B); free(C); free(ref);
+    return errors;
+}
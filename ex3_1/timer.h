@@ -20,18 +20,20 @@
  *    elapsed = finish - start;
  *    printf("The code to be timed took %e seconds\n", elapsed);
  *
+ * Note:     Uses MPI_Wtime (high resolution, not affected by adjustments
+ *           of the system clock as gettimeofday is), so it must be called
+ *           between MPI_Init and MPI_Finalize.
+ *
  * IPP:  Section 3.6.1 (p. 121) and Section 6.1.2 (pp. 273 and ff.)
  */
 #ifndef _TIMER_H_
 #define _TIMER_H_
 
-#include <sys/time.h>
+#include <mpi.h>
 
 /* The argument now should be a double (not a pointer to a double) */
 #define GET_TIME(now) { \
-   struct timeval t; \
-   gettimeofday(&t, NULL); \
-   now = t.tv_sec + t.tv_usec/1000000.0; \
+   now = MPI_Wtime(); \
 }
 
 #endif
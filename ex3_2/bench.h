@@ -0,0 +1,212 @@
+/* File:     bench.h
+ *
+ * Purpose:  Harness μετρήσεων για τα ex3_1 / ex3_2: warm-up εκτελέσεις,
+ *           R χρονομετρημένες επαναλήψεις, στατιστικά ανά επανάληψη και ανά
+ *           διεργασία και εγγραφή σε CSV ή JSON (ένα αρχείο, append).
+ *
+ * Χρήση:    bench_t b;
+ *           bench_init(&b, "ex3_2", reps, warmup);
+ *           int ph = bench_phase(&b, "calc");
+ *           for (int rep = -warmup; rep < reps; rep++) {
+ *               ... bench_record(&b, ph, rep, τοπικός χρόνος της διεργασίας);
+ *           }
+ *           bench_param(&b, "n", "%d", n);
+ *           bench_finish(&b, MPI_COMM_WORLD);   // Συλλογική
+ *           if (my_rank == 0) { bench_print(&b); bench_write(&b, path); }
+ *           bench_free(&b);
+ *
+ * Στατιστικά κάθε φάσης (οι warm-up επαναλήψεις, rep < 0, αγνοούνται):
+ *   - ανά επανάληψη: ο χρόνος της πιο αργής διεργασίας (ο χρόνος που βλέπει
+ *     ο χρήστης), και min / median / max πάνω στις R επαναλήψεις.
+ *   - ανά διεργασία: ο median χρόνος κάθε διεργασίας, και min / median / max
+ *     πάνω στις P διεργασίες. Imbalance = max / mean (1.0 = τέλεια ισορροπία).
+ *
+ * Αρχεία: κατάληξη .json -> JSON Lines (ένα αντικείμενο ανά εκτέλεση),
+ *         αλλιώς CSV σε long format (μία γραμμή ανά φάση, header αν το
+ *         αρχείο είναι κενό). Σε CSV με διαφορετικό header (άλλα κλειδιά
+ *         bench_param) δεν γράφεται τίποτα, ώστε οι στήλες να μην
+ *         μετατοπίζονται. Και τα δύο διαβάζονται από τα bench3_*.sh.
+ *
+ * Ίδιο αντίγραφο στα ex3_1/ και ex3_2/ (όπως το timer.h): κάθε άσκηση
+ * χτίζεται αυτόνομα από τον δικό της κατάλογο και Makefile. Αλλαγές
+ * γίνονται και στα δύο.
+ */
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <mpi.h>
+
+#define BENCH_MAX_PHASES 8
+#define BENCH_MAX_PARAMS 16
+
+typedef struct {
+    double min, med, max;          // Πάνω στις επαναλήψεις (max ως προς τις διεργασίες)
+    double rank_min, rank_med, rank_max, rank_mean;  // Πάνω στις διεργασίες (median ως προς τις επαναλήψεις)
+    double imbalance;              // rank_max / rank_mean
+} bench_stat_t;
+
+typedef struct {
+    const char *prog;
+    int reps, warmup, nprocs;
+    int nphases, nparams;
+    const char *phase[BENCH_MAX_PHASES];
+    double *t[BENCH_MAX_PHASES];   // t[φάση][επανάληψη]: τοπικοί χρόνοι
+    bench_stat_t stat[BENCH_MAX_PHASES];
+    char key[BENCH_MAX_PARAMS][32], val[BENCH_MAX_PARAMS][64];
+} bench_t;
+
+static int bench_cmp(const void *a, const void *b) {
+    double x = *(const double*) a, y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+// Median (ταξινομεί τον πίνακα)
+static double bench_median(double *v, int n) {
+    qsort(v, n, sizeof(double), bench_cmp);
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+static void bench_init(bench_t *b, const char *prog, int reps, int warmup) {
+    memset(b, 0, sizeof(*b));
+    b->prog = prog;
+    b->reps = reps > 0 ? reps : 1;
+    b->warmup = warmup > 0 ? warmup : 0;
+}
+
+// Επιστρέφει -1 αν δεν χωρά άλλη φάση (το bench_record την αγνοεί)
+static int bench_phase(bench_t *b, const char *name) {
+    if (b->nphases == BENCH_MAX_PHASES) return -1;
+    int p = b->nphases++;
+    b->phase[p] = name;
+    b->t[p] = (double*) calloc(b->reps, sizeof(double));
+    return p;
+}
+
+static void bench_record(bench_t *b, int phase, int rep, double sec) {
+    if (phase >= 0 && phase < b->nphases && rep >= 0 && rep < b->reps) b->t[phase][rep] = sec;
+}
+
+// Παράμετρος της εκτέλεσης (στήλη του CSV / πεδίο του JSON)
+static void bench_param(bench_t *b, const char *key, const char *fmt, ...) {
+    if (b->nparams == BENCH_MAX_PARAMS) return;
+    va_list ap;
+    va_start(ap, fmt);
+    snprintf(b->key[b->nparams], sizeof(b->key[0]), "%s", key);
+    vsnprintf(b->val[b->nparams], sizeof(b->val[0]), fmt, ap);
+    va_end(ap);
+    b->nparams++;
+}
+
+// Συλλογική: τα στατιστικά είναι έγκυρα μόνο στη διεργασία 0
+static void bench_finish(bench_t *b, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    b->nprocs = comm_sz;
+
+    int R = b->reps;
+    double *rep_max = (double*) malloc(R * sizeof(double));
+    double *tmp = (double*) malloc(R * sizeof(double));
+    double *per_rank = my_rank == 0 ? (double*) malloc(comm_sz * sizeof(double)) : NULL;
+
+    for (int p = 0; p < b->nphases; p++) {
+        bench_stat_t *s = &b->stat[p];
+        MPI_Reduce(b->t[p], rep_max, R, MPI_DOUBLE, MPI_MAX, 0, comm);
+        memcpy(tmp, b->t[p], R * sizeof(double));
+        double my_med = bench_median(tmp, R);
+        MPI_Gather(&my_med, 1, MPI_DOUBLE, per_rank, 1, MPI_DOUBLE, 0, comm);
+        if (my_rank != 0) continue;
+
+        s->med = bench_median(rep_max, R);
+        s->min = rep_max[0];
+        s->max = rep_max[R - 1];
+        double sum = 0.0;
+        for (int r = 0; r < comm_sz; r++) sum += per_rank[r];
+        s->rank_mean = sum / comm_sz;
+        s->rank_med = bench_median(per_rank, comm_sz);
+        s->rank_min = per_rank[0];
+        s->rank_max = per_rank[comm_sz - 1];
+        s->imbalance = s->rank_mean > 0.0 ? s->rank_max / s->rank_mean : 1.0;
+    }
+    free(rep_max); free(tmp); free(per_rank);
+}
+
+static void bench_print(const bench_t *b) {
+    printf("--- BENCH (%d reps, %d warm-up, P=%d; times in sec) ---\n", b->reps, b->warmup, b->nprocs);
+    printf("%-12s %12s %12s %12s | %12s %12s %12s %9s\n", "phase",
+           "rep min", "rep median", "rep max", "rank min", "rank median", "rank max", "imbal.");
+    for (int p = 0; p < b->nphases; p++) {
+        const bench_stat_t *s = &b->stat[p];
+        printf("%-12s %12e %12e %12e | %12e %12e %12e %9.3f\n", b->phase[p],
+               s->min, s->med, s->max, s->rank_min, s->rank_med, s->rank_max, s->imbalance);
+    }
+}
+
+// Αριθμητική τιμή -> χωρίς εισαγωγικά στο JSON
+static int bench_is_number(const char *v) {
+    char *end;
+    if (*v == '\0') return 0;
+    strtod(v, &end);
+    return *end == '\0';
+}
+
+// Μόνο η διεργασία 0. Επιστρέφει 0 αν γράφτηκε (-1: δεν ανοίγει / άλλο CSV header).
+static int bench_write(const bench_t *b, const char *path) {
+    FILE *fp = fopen(path, "a+");
+    if (!fp) return -1;
+    size_t len = strlen(path);
+    int json = len >= 5 && strcmp(path + len - 5, ".json") == 0;
+
+    if (json) {
+        fprintf(fp, "{\"prog\": \"%s\", \"P\": %d, \"reps\": %d, \"warmup\": %d",
+                b->prog, b->nprocs, b->reps, b->warmup);
+        for (int k = 0; k < b->nparams; k++) {
+            if (bench_is_number(b->val[k])) fprintf(fp, ", \"%s\": %s", b->key[k], b->val[k]);
+            else fprintf(fp, ", \"%s\": \"%s\"", b->key[k], b->val[k]);
+        }
+        fprintf(fp, ", \"phases\": {");
+        for (int p = 0; p < b->nphases; p++) {
+            const bench_stat_t *s = &b->stat[p];
+            fprintf(fp, "%s\"%s\": {\"min\": %.9e, \"median\": %.9e, \"max\": %.9e, "
+                        "\"rank_min\": %.9e, \"rank_median\": %.9e, \"rank_max\": %.9e, \"imbalance\": %.6f}",
+                    p ? ", " : "", b->phase[p], s->min, s->med, s->max,
+                    s->rank_min, s->rank_med, s->rank_max, s->imbalance);
+        }
+        fprintf(fp, "}}\n");
+    } else {
+        char hdr[1024], line[1024];
+        int h = snprintf(hdr, sizeof(hdr), "prog,P,reps,warmup");
+        for (int k = 0; k < b->nparams; k++) h += snprintf(hdr + h, sizeof(hdr) - h, ",%s", b->key[k]);
+        snprintf(hdr + h, sizeof(hdr) - h, ",phase,min,median,max,rank_min,rank_median,rank_max,imbalance\n");
+
+        // Υπάρχον αρχείο: οι γραμμές μπαίνουν μόνο κάτω από το ίδιο header
+        rewind(fp);
+        if (fgets(line, sizeof(line), fp)) {
+            if (strcmp(line, hdr) != 0) {
+                fclose(fp);
+                return -1;
+            }
+        }
+        fseek(fp, 0, SEEK_END);          // Ανάγνωση -> εγγραφή στο ίδιο stream
+        if (ftell(fp) == 0) fputs(hdr, fp);
+        for (int p = 0; p < b->nphases; p++) {
+            const bench_stat_t *s = &b->stat[p];
+            fprintf(fp, "%s,%d,%d,%d", b->prog, b->nprocs, b->reps, b->warmup);
+            for (int k = 0; k < b->nparams; k++) fprintf(fp, ",%s", b->val[k]);
+            fprintf(fp, ",%s,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.6f\n", b->phase[p],
+                    s->min, s->med, s->max, s->rank_min, s->rank_med, s->rank_max, s->imbalance);
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+static void bench_free(bench_t *b) {
+    for (int p = 0; p < b->nphases; p++) free(b->t[p]);
+}
+
+#endif
@@ -0,0 +1,80 @@
+#!/bin/bash
+
+# --- Sweep μετρήσεων με το harness (bench.h) ---
+# Κάθε συνδυασμός τρέχει με warm-up + REPS επαναλήψεις των βρόχων SpMV και
+# γράφει μία γραμμή ανά φάση στο CSV (min/median/max ως προς επαναλήψεις και
+# διεργασίες). Στο τέλος υπολογίζονται speedup S(P) = T(P_min) / T(P) και
+# efficiency E(P) = S(P) * P_min / P για τις φάσεις csr_calc και dense_calc.
+#
+# Όλες οι ρυθμίσεις αλλάζουν από το περιβάλλον, π.χ.
+#   SIZES="2048" PROCESSES="1 2 4" OPTS="-e halo" MPIEXEC="mpiexec --oversubscribe" ./bench3_2.sh
+
+SIZES=${SIZES:-"1024 10240"}
+SPARSITIES=${SPARSITIES:-"0.00 0.50 0.99"}
+ITER_COUNTS=${ITER_COUNTS:-"1 10 20"}
+PROCESSES=${PROCESSES:-"1 2 4 8 16 32"}
+THREADS=${THREADS:-1}
+OPTS=${OPTS:-""}          # Επιπλέον επιλογές του ex3_2 (π.χ. "-d -e halo -f auto")
+REPS=${REPS:-5}
+WARMUP=${WARMUP:-1}
+
+MACHINES_FILE=${MACHINES_FILE:-machines}
+MPIEXEC=${MPIEXEC:-"mpiexec -f $MACHINES_FILE"}
+CSV_FILE=${CSV_FILE:-bench_ex3_2.csv}
+TABLE_FILE=${TABLE_FILE:-speedup_ex3_2.dat}
+LOG_FILE=${LOG_FILE:-bench_ex3_2.log}
+
+# --- Build ---
+echo "--- Compiling Project ---"
+make
+
+if [ ! -f ./ex3_2 ]; then
+    echo "❌ Error: Compilation failed!"
+    exit 1
+fi
+
+rm -f $CSV_FILE $LOG_FILE
+
+# --- Execution Loops ---
+echo "🚀 Starting Experiments..."
+
+for n in $SIZES; do
+    for sp in $SPARSITIES; do
+        for iters in $ITER_COUNTS; do
+            for p in $PROCESSES; do
+                # Τουλάχιστον μία γραμμή ανά διεργασία
+                if (( n < p )); then
+                    continue
+                fi
+                echo "   Running: N=$n | Sparsity=$sp | Iters=$iters | P=$p"
+                $MPIEXEC -n $p ./ex3_2 -t $THREADS $OPTS -r $REPS -u $WARMUP -R $CSV_FILE $n $sp $iters >> $LOG_FILE
+            done
+        done
+    done
+done
+
+# --- Speedup / efficiency ---
+# Μία ομάδα ανά συνδυασμό παραμέτρων και φάση (όλες οι στήλες εκτός του P),
+# χωρισμένες με δύο κενές γραμμές: στο gnuplot κάθε ομάδα είναι ένα "index".
+awk -F, -v PHASES="csr_calc dense_calc" '
+BEGIN { split(PHASES, ph, " "); for (i in ph) want[ph[i]] = 1 }
+NR == 1 {
+    for (i = 1; i <= NF; i++) { col[$i] = i; name[i] = $i }
+    stats = col["phase"]
+    next
+}
+($stats in want) && $col["median"] > 0 {
+    key = ""
+    for (i = 1; i <= stats; i++) if (i != col["P"]) key = key sprintf("%s=%s ", name[i], $i)
+    if (!(key in base)) { order[++nkeys] = key; base[key] = $col["median"]; pmin[key] = $col["P"] }
+    rows[key] = rows[key] sprintf("%6d %14e %9.3f %9.3f\n", $col["P"], $col["median"],
+                                  base[key] / $col["median"],
+                                  base[key] / $col["median"] * pmin[key] / $col["P"])
+}
+END {
+    for (k = 1; k <= nkeys; k++)
+        printf("# %s\n# %4s %14s %9s %9s\n%s\n\n", order[k], "P", "median", "speedup", "effic.", rows[order[k]])
+}' $CSV_FILE > $TABLE_FILE
+
+echo "✅ All experiments finished!"
+echo "📄 Raw results: $CSV_FILE, speedup tables: $TABLE_FILE"
@@ -0,0 +1,335 @@
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "spmv.h"
+#include "timer.h"
+
+/* ======================================================
+   Συμπαγές CSR: 16-bit διαφορές στηλών και float / λεξικό τιμών
+   ======================================================
+   Το CSR διαβάζει 4 (στήλη) + 8 (τιμή) bytes ανά μη-μηδενικό.
+   - Στήλες: οι γραμμές ομαδοποιούνται σε chunks των CCSR_CHUNK γραμμών και
+     κάθε στήλη αποθηκεύεται ως (προσημασμένη) διαφορά 16 bit από την
+     προηγούμενη του chunk (η πρώτη από το 0). Διαφορές εκτός εύρους
+     γράφονται ως CCSR_ESC και ακολουθούν 2 x 16 bit με την απόλυτη στήλη.
+     Προσημασμένες, γιατί μετά το halo οι ghosts αριθμούνται μετά τις δικές
+     μας στήλες και η σειρά μέσα στη γραμμή δεν είναι αύξουσα.
+   - Τιμές: double (8 B), float (4 B) ή δείκτης 8 bit σε λεξικό έως
+     CCSR_DICT_MAX διακριτών τιμών (1 B). Η συσσώρευση γίνεται πάντα σε double.
+   Τα chunks είναι ανεξάρτητα (το καθένα ξεκινά από στήλη 0), οπότε
+   μοιράζονται στα νήματα και κόβονται στα όρια των διεργασιών για τη διανομή. */
+
+static size_t val_size(cval_t m) {
+    return m == CVAL_DICT ? sizeof(uint8_t) : m == CVAL_FLOAT ? sizeof(float) : sizeof(double);
+}
+
+// Αριθμός 16-bit λέξεων για τη στήλη c μετά την prev
+static int col_words(int prev, int c) {
+    long d = (long) c - prev;
+    return d > INT16_MIN && d <= INT16_MAX ? 1 : 3;
+}
+
+static int put_col(int16_t *s, int prev, int c) {
+    long d = (long) c - prev;
+    if (d > INT16_MIN && d <= INT16_MAX) { s[0] = (int16_t) d; return 1; }
+    s[0] = CCSR_ESC;
+    s[1] = (int16_t) (uint16_t) ((uint32_t) c & 0xFFFF);
+    s[2] = (int16_t) (uint16_t) ((uint32_t) c >> 16);
+    return 3;
+}
+
+static inline int next_col(const int16_t *s, int *p, int prev) {
+    int16_t d = s[(*p)++];
+    if (d != CCSR_ESC) return prev + d;
+    uint32_t c = (uint16_t) s[*p] | ((uint32_t) (uint16_t) s[*p + 1] << 16);
+    *p += 2;
+    return (int) c;
+}
+
+// Λεξικό των διακριτών τιμών (έως CCSR_DICT_MAX). Επιστρέφει -1 αν είναι περισσότερες.
+static int build_dict(const double *v, int nnz, double *dict) {
+    int nd = 0;
+    for (int k = 0; k < nnz; k++) {
+        int d = 0;
+        while (d < nd && dict[d] != v[k]) d++;
+        if (d == nd) {
+            if (nd == CCSR_DICT_MAX) return -1;
+            dict[nd++] = v[k];
+        }
+    }
+    return nd;
+}
+
+static int dict_index(const double *dict, int nd, double v) {
+    int d = 0;
+    while (d < nd - 1 && dict[d] != v) d++;
+    return d;
+}
+
+int ccsr_float_exact(const csr_t *A) {
+    for (int k = 0; k < A->nnz; k++) if ((double) (float) A->values[k] != A->values[k]) return 0;
+    return 1;
+}
+
+// Συλλογική: ίδια μορφή τιμών σε όλες τις διεργασίες. Λεξικό μόνο αν χωράει
+// σε όλες (κάθε διεργασία έχει το δικό της), float μόνο αν είναι ακριβές σε όλες.
+cval_t ccsr_vmode(const csr_t *A, cval_t vmode, MPI_Comm comm) {
+    if (vmode == CVAL_DOUBLE || vmode == CVAL_FLOAT) return vmode;
+    double dict[CCSR_DICT_MAX];
+    int ok[2] = { build_dict(A->values, A->nnz, dict) >= 0, ccsr_float_exact(A) };
+    MPI_Allreduce(MPI_IN_PLACE, ok, 2, MPI_INT, MPI_MIN, comm);
+    return ok[0] ? CVAL_DICT : ok[1] ? CVAL_FLOAT : CVAL_DOUBLE;
+}
+
+ccsr_t ccsr_encode(const csr_t *A, const int *blk_off, int nblk, cval_t vmode) {
+    ccsr_t C;
+    memset(&C, 0, sizeof(C));
+    C.n = A->n;
+    C.nnz = A->nnz;
+
+    // Τιμές: auto -> λεξικό αν χωράει, αλλιώς float αν είναι ακριβές, αλλιώς double
+    int nd = vmode == CVAL_DOUBLE || vmode == CVAL_FLOAT ? -1 : build_dict(A->values, A->nnz, C.dict);
+    if (vmode == CVAL_AUTO) vmode = nd >= 0 ? CVAL_DICT : ccsr_float_exact(A) ? CVAL_FLOAT : CVAL_DOUBLE;
+    if (vmode == CVAL_DICT && nd < 0)                         // > CCSR_DICT_MAX τιμές
+        vmode = ccsr_float_exact(A) ? CVAL_FLOAT : CVAL_DOUBLE;
+    C.vmode = vmode;
+    C.ndict = vmode == CVAL_DICT ? nd : 0;
+
+    // Chunks: κάθε CCSR_CHUNK γραμμές, με νέο chunk σε κάθε όριο blk_off
+    C.nchunks = 0;
+    for (int b = 0; b < nblk; b++) C.nchunks += (blk_off[b + 1] - blk_off[b] + CCSR_CHUNK - 1) / CCSR_CHUNK;
+    C.chunk_row = (int*) malloc((C.nchunks + 1) * sizeof(int));
+    C.chunk_off = (int*) malloc((C.nchunks + 1) * sizeof(int));
+    for (int b = 0, c = 0; b < nblk; b++)
+        for (int i = blk_off[b]; i < blk_off[b + 1]; i += CCSR_CHUNK) C.chunk_row[c++] = i;
+    C.chunk_row[C.nchunks] = A->n;
+
+    // Pass 1: μήκος της ροής στηλών ανά chunk
+    C.chunk_off[0] = 0;
+    for (int c = 0; c < C.nchunks; c++) {
+        int words = 0, prev = 0;
+        for (int k = A->row_ptr[C.chunk_row[c]]; k < A->row_ptr[C.chunk_row[c + 1]]; k++) {
+            words += col_words(prev, A->col_ind[k]);
+            prev = A->col_ind[k];
+        }
+        C.chunk_off[c + 1] = C.chunk_off[c] + words;
+    }
+    C.ncols = C.chunk_off[C.nchunks];
+
+    // Pass 2: γέμισμα
+    C.row_ptr = (int*) malloc((C.n + 1) * sizeof(int));
+    memcpy(C.row_ptr, A->row_ptr, (C.n + 1) * sizeof(int));
+    C.cols = (int16_t*) malloc((C.ncols + 1) * sizeof(int16_t));
+    C.values = malloc((C.nnz + 1) * val_size(vmode));
+
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < C.nchunks; c++) {
+        int p = C.chunk_off[c], prev = 0;
+        for (int k = A->row_ptr[C.chunk_row[c]]; k < A->row_ptr[C.chunk_row[c + 1]]; k++) {
+            p += put_col(C.cols + p, prev, A->col_ind[k]);
+            prev = A->col_ind[k];
+        }
+    }
+    if (vmode == CVAL_DOUBLE) memcpy(C.values, A->values, C.nnz * sizeof(double));
+    else if (vmode == CVAL_FLOAT)
+        for (int k = 0; k < C.nnz; k++) ((float*) C.values)[k] = (float) A->values[k];
+    else
+        for (int k = 0; k < C.nnz; k++) ((uint8_t*) C.values)[k] = (uint8_t) dict_index(C.dict, nd, A->values[k]);
+    return C;
+}
+
+csr_t ccsr_decode(const ccsr_t *C) {
+    csr_t A;
+    A.n = C->n;
+    A.nnz = C->nnz;
+    A.row_ptr = (int*) malloc((A.n + 1) * sizeof(int));
+    A.col_ind = (int*) malloc((A.nnz + 1) * sizeof(int));
+    A.values = (double*) malloc((A.nnz + 1) * sizeof(double));
+    memcpy(A.row_ptr, C->row_ptr, (A.n + 1) * sizeof(int));
+
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < C->nchunks; c++) {
+        int p = C->chunk_off[c], col = 0;
+        for (int k = C->row_ptr[C->chunk_row[c]]; k < C->row_ptr[C->chunk_row[c + 1]]; k++) {
+            col = next_col(C->cols, &p, col);
+            A.col_ind[k] = col;
+        }
+    }
+    for (int k = 0; k < A.nnz; k++)
+        A.values[k] = C->vmode == CVAL_DOUBLE ? ((const double*) C->values)[k] :
+                      C->vmode == CVAL_FLOAT ? ((const float*) C->values)[k] :
+                      C->dict[((const uint8_t*) C->values)[k]];
+    return A;
+}
+
+void free_ccsr(ccsr_t *C) {
+    free(C->row_ptr); free(C->chunk_row); free(C->chunk_off);
+    free(C->cols); free(C->values);
+}
+
+size_t ccsr_bytes(const ccsr_t *C) {
+    return (size_t) C->ncols * sizeof(int16_t) + (size_t) C->nnz * val_size(C->vmode) +
+           (size_t) (C->n + 1) * sizeof(int) + (size_t) C->nchunks * 2 * sizeof(int) +
+           (size_t) C->ndict * sizeof(double);
+}
+
+/* --- Πυρήνες: ένα chunk ανά κλήση, μία παραλλαγή ανά μορφή τιμών --- */
+
+#define CCSR_CHUNK_BODY(VAL)                                                     \
+    int p = C->chunk_off[c], col = 0;                                            \
+    for (int i = C->chunk_row[c]; i < C->chunk_row[c + 1]; i++) {                \
+        double sum = 0.0;                                                        \
+        for (int k = C->row_ptr[i]; k < C->row_ptr[i + 1]; k++) {                \
+            col = next_col(C->cols, &p, col);                                    \
+            sum += (VAL) * x[col];                                               \
+        }                                                                        \
+        y[i] = sum;                                                              \
+    }
+
+static void chunk_double(const ccsr_t *C, int c, const double *x, double *y) {
+    const double *v = (const double*) C->values;
+    CCSR_CHUNK_BODY(v[k])
+}
+
+static void chunk_float(const ccsr_t *C, int c, const double *x, double *y) {
+    const float *v = (const float*) C->values;
+    CCSR_CHUNK_BODY((double) v[k])
+}
+
+static void chunk_dict(const ccsr_t *C, int c, const double *x, double *y) {
+    const uint8_t *v = (const uint8_t*) C->values;
+    CCSR_CHUNK_BODY(C->dict[v[k]])
+}
+
+typedef void (*ccsr_chunk_fn)(const ccsr_t *C, int c, const double *x, double *y);
+
+void ccsr_spmv(const ccsr_t *C, const double *x, double *y) {
+    ccsr_chunk_fn chunk = C->vmode == CVAL_FLOAT ? chunk_float : C->vmode == CVAL_DICT ? chunk_dict : chunk_double;
+    #pragma omp parallel for schedule(guided)
+    for (int c = 0; c < C->nchunks; c++) chunk(C, c, x, y);
+}
+
+/* --- Διανομή του συμπαγούς πίνακα του Master --- */
+// Ο global πρέπει να έχει κωδικοποιηθεί με blk_off = row_off, ώστε κανένα chunk
+// να μην περνά όριο διεργασιών. Μεταφέρει ccsr_bytes() αντί για 12 B / nnz.
+ccsr_t ccsr_scatter(const ccsr_t *global, const int *row_off, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    int lo = row_off[my_rank], local_n = row_off[my_rank + 1] - lo;
+
+    // Μεγέθη ανά διεργασία: chunks, λέξεις στηλών, nnz
+    int *cnt = NULL, *cdispl = NULL, *wcnt = NULL, *wdispl = NULL, *vcnt = NULL, *vdispl = NULL;
+    int *rcnt = NULL, *rdispl = NULL;
+    int meta[4];   // nchunks, ncols, nnz, vmode
+    if (my_rank == 0) {
+        size_t vs = val_size(global->vmode);
+        cnt = malloc(comm_sz * sizeof(int)); cdispl = malloc(comm_sz * sizeof(int));
+        wcnt = malloc(comm_sz * sizeof(int)); wdispl = malloc(comm_sz * sizeof(int));
+        vcnt = malloc(comm_sz * sizeof(int)); vdispl = malloc(comm_sz * sizeof(int));
+        rcnt = malloc(comm_sz * sizeof(int)); rdispl = malloc(comm_sz * sizeof(int));
+        int c = 0;
+        for (int r = 0; r < comm_sz; r++) {
+            cdispl[r] = c;
+            while (c < global->nchunks && global->chunk_row[c] < row_off[r + 1]) c++;
+            cnt[r] = c - cdispl[r];
+            wdispl[r] = global->chunk_off[cdispl[r]];
+            wcnt[r] = global->chunk_off[c] - wdispl[r];
+            // Τιμές ως bytes (ο τύπος εξαρτάται από τη μορφή)
+            vdispl[r] = global->row_ptr[row_off[r]] * vs;
+            vcnt[r] = (global->row_ptr[row_off[r + 1]] - global->row_ptr[row_off[r]]) * vs;
+            rdispl[r] = row_off[r];
+            rcnt[r] = row_off[r + 1] - row_off[r];
+        }
+    }
+
+    ccsr_t C;
+    memset(&C, 0, sizeof(C));
+    int mine[3];
+    if (my_rank == 0) meta[3] = global->vmode;
+    MPI_Bcast(&meta[3], 1, MPI_INT, 0, comm);
+    MPI_Scatter(cnt, 1, MPI_INT, &mine[0], 1, MPI_INT, 0, comm);
+    MPI_Scatter(wcnt, 1, MPI_INT, &mine[1], 1, MPI_INT, 0, comm);
+    MPI_Scatter(vcnt, 1, MPI_INT, &mine[2], 1, MPI_INT, 0, comm);
+    C.vmode = (cval_t) meta[3];
+    C.n = local_n;
+    C.nchunks = mine[0];
+    C.ncols = mine[1];
+    C.nnz = mine[2] / (int) val_size(C.vmode);
+
+    // Λεξικό: κοινό σε όλους
+    if (my_rank == 0) C.ndict = global->ndict;
+    MPI_Bcast(&C.ndict, 1, MPI_INT, 0, comm);
+    if (my_rank == 0) memcpy(C.dict, global->dict, sizeof(C.dict));
+    MPI_Bcast(C.dict, C.ndict, MPI_DOUBLE, 0, comm);
+
+    C.row_ptr = (int*) malloc((local_n + 1) * sizeof(int));
+    C.chunk_row = (int*) malloc((C.nchunks + 1) * sizeof(int));
+    C.chunk_off = (int*) malloc((C.nchunks + 1) * sizeof(int));
+    C.cols = (int16_t*) malloc((C.ncols + 1) * sizeof(int16_t));
+    C.values = malloc(mine[2] + 1);
+
+    MPI_Scatterv(my_rank == 0 ? global->row_ptr : NULL, rcnt, rdispl, MPI_INT,
+                 C.row_ptr, local_n, MPI_INT, 0, comm);
+    MPI_Scatterv(my_rank == 0 ? global->chunk_row : NULL, cnt, cdispl, MPI_INT,
+                 C.chunk_row, C.nchunks, MPI_INT, 0, comm);
+    MPI_Scatterv(my_rank == 0 ? global->chunk_off : NULL, cnt, cdispl, MPI_INT,
+                 C.chunk_off, C.nchunks, MPI_INT, 0, comm);
+    MPI_Scatterv(my_rank == 0 ? global->cols : NULL, wcnt, wdispl, MPI_SHORT,
+                 C.cols, C.ncols, MPI_SHORT, 0, comm);
+    MPI_Scatterv(my_rank == 0 ? global->values : NULL, vcnt, vdispl, MPI_BYTE,
+                 C.values, mine[2], MPI_BYTE, 0, comm);
+
+    // Τοπικοί (0-based) δείκτες
+    int r0 = local_n > 0 ? C.row_ptr[0] : 0, w0 = C.nchunks > 0 ? C.chunk_off[0] : 0;
+    for (int i = 0; i < local_n; i++) C.row_ptr[i] -= r0;
+    C.row_ptr[local_n] = C.nnz;
+    for (int c = 0; c < C.nchunks; c++) { C.chunk_row[c] -= lo; C.chunk_off[c] -= w0; }
+    C.chunk_row[C.nchunks] = local_n;
+    C.chunk_off[C.nchunks] = C.ncols;
+
+    free(cnt); free(cdispl); free(wcnt); free(wdispl);
+    free(vcnt); free(vdispl); free(rcnt); free(rdispl);
+    return C;
+}
+
+// Συλλογική: χρόνος ανά SpMV (μόνο πυρήνας, max ως προς τις διεργασίες) με το
+// CSR και με το συμπαγές CSR, στον ίδιο πίνακα και x
+void ccsr_compare(const csr_t *A, const ccsr_t *C, const double *x, MPI_Comm comm,
+                  double *t_csr, double *t_ccsr) {
+    double *y = (double*) malloc((A->n + 1) * sizeof(double));
+    double t[2], t0, t1;
+
+    MPI_Barrier(comm);
+    GET_TIME(t0);
+    for (int it = 0; it < CCSR_PROBE_ITERS; it++) {
+        #pragma omp parallel for schedule(guided)
+        for (int i = 0; i < A->n; i++) {
+            double sum = 0.0;
+            for (int j = A->row_ptr[i]; j < A->row_ptr[i + 1]; j++) sum += A->values[j] * x[A->col_ind[j]];
+            y[i] = sum;
+        }
+    }
+    GET_TIME(t1);
+    t[0] = (t1 - t0) / CCSR_PROBE_ITERS;
+
+    MPI_Barrier(comm);
+    GET_TIME(t0);
+    for (int it = 0; it < CCSR_PROBE_ITERS; it++) ccsr_spmv(C, x, y);
+    GET_TIME(t1);
+    t[1] = (t1 - t0) / CCSR_PROBE_ITERS;
+
+    MPI_Allreduce(MPI_IN_PLACE, t, 2, MPI_DOUBLE, MPI_MAX, comm);
+    *t_csr = t[0];
+    *t_ccsr = t[1];
+    free(y);
+}
+
+const char *cval_name(cval_t m) {
+    switch (m) {
+        case CVAL_FLOAT: return "float";
+        case CVAL_DICT:  return "dict";
+        case CVAL_AUTO:  return "auto";
+        default:         return "double";
+    }
+}
@@ -0,0 +1,153 @@
+#include <stdlib.h>
+#include <limits.h>
+#include "spmv.h"
+
+/* --- Μετατροπή Dense -> CSR --- */
+// Υλοποιείται σε 2 περάσματα, παράλληλα ως προς τις γραμμές:
+// 1. Καταμέτρηση NNZ ανά γραμμή και prefix sum (64-bit) για τις αρχές των γραμμών.
+// 2. Γέμισμα των πινάκων values, col_ind, row_ptr (κάθε γραμμή ανεξάρτητα).
+
+// Παράλληλο prefix sum: off[i+1] = πλήθος της γραμμής i -> off[i] = αρχή της γραμμής i.
+// Κάθε νήμα αθροίζει ένα συνεχές τμήμα, ένα νήμα σαρώνει τα T αθροίσματα, και
+// κάθε νήμα προσθέτει τη μετατόπιση του τμήματός του.
+static void prefix_sum(long long *off, int m) {
+    long long *part = (long long*) calloc(omp_get_max_threads() + 1, sizeof(long long));
+    off[0] = 0;
+    #pragma omp parallel
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        int i0 = (int) ((long long) t * m / nt), i1 = (int) ((long long) (t + 1) * m / nt);
+        long long s = 0;
+        for (int i = i0; i < i1; i++) { s += off[i + 1]; off[i + 1] = s; }
+        part[t + 1] = s;
+        #pragma omp barrier
+        #pragma omp single
+        for (int k = 1; k <= nt; k++) part[k] += part[k - 1];
+        for (int i = i0; i < i1; i++) off[i + 1] += part[t];
+    }
+    free(part);
+}
+
+csr_t dense2csr_rows(const double *D, int rows, int n) {
+    csr_t mat = { NULL, NULL, NULL, rows, 0 };
+    long long *off = (long long*) malloc((rows + 1) * sizeof(long long));
+
+    // Pass 1: Μέτρηση μη-μηδενικών ανά γραμμή
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < rows; i++) {
+        const double *row = D + (size_t) i * n;
+        long long c = 0;
+        for (int j = 0; j < n; j++) c += row[j] != 0.0;
+        off[i + 1] = c;
+    }
+    prefix_sum(off, rows);
+
+    // Οι δείκτες του csr_t είναι 32-bit: το τμήμα πρέπει να χωράει
+    if (off[rows] > INT_MAX) {
+        mat.nnz = -1;
+        free(off);
+        return mat;
+    }
+    mat.nnz = (int) off[rows];
+    mat.values = (double*) malloc((off[rows] + 1) * sizeof(double));
+    mat.col_ind = (int*) malloc((off[rows] + 1) * sizeof(int));
+    mat.row_ptr = (int*) malloc((rows + 1) * sizeof(int));
+
+    // Pass 2: Γέμισμα δομής (η γραμμή i γράφει από το off[i])
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < rows; i++) {
+        const double *row = D + (size_t) i * n;
+        long long k = off[i];
+        for (int j = 0; j < n; j++) {
+            if (row[j] != 0.0) {
+                mat.values[k] = row[j];
+                mat.col_ind[k] = j;
+                k++;
+            }
+        }
+        mat.row_ptr[i] = (int) off[i];
+    }
+    mat.row_ptr[rows] = mat.nnz;
+    free(off);
+    return mat;
+}
+
+csr_t dense2csr(double *A_dense, int n) {
+    return dense2csr_rows(A_dense, n, n);
+}
+
+// Dense αντίγραφο των τοπικών γραμμών (για το Dense πείραμα όταν δεν υπάρχει global πίνακας)
+double *csr_to_dense_rows(const csr_t *A, int n) {
+    double *D = (double*) calloc((size_t) A->n * n, sizeof(double));
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < A->n; i++)
+        for (int j = A->row_ptr[i]; j < A->row_ptr[i + 1]; j++)
+            D[(size_t) i * n + A->col_ind[j]] += A->values[j];
+    return D;
+}
+
+// Συνάρτηση αποδέσμευσης CSR
+void free_csr(csr_t *mat) {
+    if (mat->values) free(mat->values);
+    if (mat->col_ind) free(mat->col_ind);
+    if (mat->row_ptr) free(mat->row_ptr);
+}
+
+/* --- Διανομή του CSR του Master σε μπλοκ γραμμών --- */
+// Η διεργασία r λαμβάνει τις γραμμές [row_off[r], row_off[r+1]) με τοπικό (0-based) row_ptr.
+// Το global ορίζεται μόνο στον Master (root 0 του comm).
+csr_t csr_scatter(const csr_t *global, const int *row_off, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+
+    int local_n = row_off[my_rank + 1] - row_off[my_rank];
+    int local_nnz;            // Μη-μηδενικά ανά διεργασία (διαφέρει στον καθένα)
+    
+    // Πίνακες για το Scatterv (διαχειρίζονται τα άνισα μεγέθη δεδομένων)
+    int *scounts = NULL, *displs = NULL;
+
+    if (my_rank == 0) {
+        scounts = malloc(comm_sz * sizeof(int));
+        displs = malloc(comm_sz * sizeof(int));
+        
+        // Υπολογισμός κατανομής φορτίου (nnz) ανά διεργασία
+        for (int i=0; i<comm_sz; i++) {
+            int start = row_off[i];
+            int end = row_off[i+1];
+            scounts[i] = global->row_ptr[end] - global->row_ptr[start];
+            displs[i] = global->row_ptr[start];
+        }
+    }
+
+    // 1. Ενημέρωση διεργασιών για το μέγεθος δεδομένων που θα λάβουν (local_nnz)
+    MPI_Scatter(scounts, 1, MPI_INT, &local_nnz, 1, MPI_INT, 0, comm);
+
+    // 2. Δέσμευση Τοπικής Μνήμης CSR
+    csr_t local_csr;
+    local_csr.n = local_n;
+    local_csr.nnz = local_nnz;
+    local_csr.values = malloc(local_nnz * sizeof(double));
+    local_csr.col_ind = malloc(local_nnz * sizeof(int));
+    local_csr.row_ptr = malloc((local_n + 1) * sizeof(int));
+
+    // 3. Διανομή δεδομένων (Χρήση Scatterv λόγω ανισοκατανομής των μηδενικών)
+    MPI_Scatterv(my_rank==0 ? global->values : NULL, scounts, displs, MPI_DOUBLE, 
+                 local_csr.values, local_nnz, MPI_DOUBLE, 0, comm);
+    MPI_Scatterv(my_rank==0 ? global->col_ind : NULL, scounts, displs, MPI_INT, 
+                 local_csr.col_ind, local_nnz, MPI_INT, 0, comm);
+    
+    // 4. Διανομή row_ptr (Scatterv: τα μπλοκ γραμμών δεν έχουν απαραίτητα ίδιο μέγεθος)
+    int *rcounts = part_counts(row_off, comm_sz);
+    MPI_Scatterv(my_rank==0 ? global->row_ptr : NULL, rcounts, row_off, MPI_INT,
+                 local_csr.row_ptr, local_n, MPI_INT, 0, comm);
+    free(rcounts);
+
+    // 5. Normalization: Διόρθωση των δεικτών row_ptr ώστε να είναι τοπικοί (0-based)
+    int start_idx = local_csr.row_ptr[0];
+    for(int i=0; i<local_n; i++) local_csr.row_ptr[i] -= start_idx;
+    local_csr.row_ptr[local_n] = local_nnz; // Τελευταίο στοιχείο = συνολικά στοιχεία
+
+    free(scounts); free(displs);
+    return local_csr;
+}
@@ -1,58 +1,36 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <unistd.h>
 #include <mpi.h>
 #include "timer.h" 
+#include "bench.h"
+#include "perf.h"
 
-/* --- Δομή CSR (Compressed Sparse Row) --- */
-typedef struct {
-    double *values;   // Μη-μηδενικές τιμές
-    int *col_ind;     // Δείκτες στήλης για κάθε τιμή
-    int *row_ptr;     // Δείκτες αρχής κάθε γραμμής
-    int n;            // Αριθμός γραμμών
-    int nnz;          // Πλήθος μη-μηδενικών στοιχείων (Number of Non-Zeros)
-} csr_t;
-
-/* --- Μετατροπή Dense -> CSR --- */
-// Υλοποιείται σε 2 περάσματα: 
-// 1. Καταμέτρηση NNZ για δέσμευση μνήμης.
-// 2. Γέμισμα των πινάκων values, col_ind, row_ptr.
-csr_t dense2csr(double *A_dense, int n) {
-    csr_t mat;
-    mat.n = n;
-    int count = 0;
-    
-    // Pass 1: Μέτρηση μη-μηδενικών
-    for (int i = 0; i < n * n; i++) if (A_dense[i] != 0.0) count++;
-    mat.nnz = count;
-
-    // Δέσμευση μνήμης για CSR
-    mat.values = (double*) malloc(count * sizeof(double));
-    mat.col_ind = (int*) malloc(count * sizeof(int));
-    mat.row_ptr = (int*) malloc((n + 1) * sizeof(int));
-
-    // Pass 2: Γέμισμα δομής
-    int current_nnz = 0;
-    mat.row_ptr[0] = 0;
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            double val = A_dense[i*n + j];
-            if (val != 0.0) {
-                mat.values[current_nnz] = val;
-                mat.col_ind[current_nnz] = j;
-                current_nnz++;
-            }
-        }
-        mat.row_ptr[i+1] = current_nnz; // Τέλος τρέχουσας γραμμής / Αρχή επόμενης
-    }
-    return mat;
+#include "spmv.h"
+
+// Πάνω από αυτό το μέγεθος τοπικού dense μπλοκ (πίνακες από αρχείο) το Dense πείραμα παραλείπεται
+#define DENSE_MAX_BYTES (1L << 30)
+
+// Overlap: πόση από την (ανασταλτική) επικοινωνία κρύφτηκε πίσω από τον υπολογισμό
+static void print_overlap(const char *name, double t_exch, double wait, int iters) {
+    double blocking = t_exch * iters;
+    double hidden = blocking > 0.0 ? 1.0 - wait / blocking : 0.0;
+    if (hidden < 0.0) hidden = 0.0;
+    printf("%-6s Overlap:                %e s/iter exchange (blocking), %e s/iter exposed, %.0f%% hidden\n",
+           name, t_exch, iters > 0 ? wait / iters : 0.0, 100.0 * hidden);
 }
 
-// Συνάρτηση αποδέσμευσης CSR
-void free_csr(csr_t *mat) {
-    if (mat->values) free(mat->values);
-    if (mat->col_ind) free(mat->col_ind);
-    if (mat->row_ptr) free(mat->row_ptr);
+// Εκτιμώμενη κίνηση μνήμης ενός SpMV (-H): ο πίνακας στη μορφή του βρόχου, κάθε
+// στοιχείο του x που χρησιμοποιείται μία φορά (ncols: μήκος του x) και το y
+static double spmv_bytes(const csr_t *A, double mat_bytes, int ncols) {
+    char *used = (char*) calloc(ncols, 1);
+    long long distinct = 0;
+    for (int k = 0; k < A->nnz; k++)
+        if (!used[A->col_ind[k]]) { used[A->col_ind[k]] = 1; distinct++; }
+    free(used);
+    return mat_bytes + (double) distinct * sizeof(double) + (double) A->n * sizeof(double);
 }
 
 int main(int argc, char* argv[]) {
@@ -68,22 +46,162 @@ int main(int argc, char* argv[]) {
     double t_dense_calc_start = 0.0, t_dense_calc_end = 0.0;
 
     // MPI Initialization
-    MPI_Init(&argc, &argv);
+    // FUNNELED: μόνο το κύριο νήμα κάνει κλήσεις MPI (εκτός παράλληλων περιοχών)
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
 
     // Έλεγχος Ορισμάτων
-    if (argc != 4) {
-        if (my_rank == 0) printf("Usage: %s <n> <sparsity> <iters>\n", argv[0]);
+    int nthreads = 1;   // Νήματα ανά διεργασία (default: καθαρό MPI)
+    int shared = 0;     // Ένα κοινόχρηστο x ανά κόμβο αντί για ένα ανά διεργασία
+    int distgen = 0;    // Κάθε διεργασία παράγει τις γραμμές της (χωρίς dense πίνακα στον Master)
+    exch_mode_t exch = EXCH_ALLGATHER;
+    int overlap = 0;    // Μη-ανασταλτική ανανέωση του x, επικαλυπτόμενη με interior γραμμές
+    fmt_t fmt = FMT_CSR;
+    const char *infile = NULL;   // Πίνακας από αρχείο (.mtx ή binary CSR) αντί για τυχαίο
+    const char *outfile = NULL;  // Αποθήκευση του πίνακα σε binary CSR
+    int reorder = 0;             // Αναδιάταξη RCM πριν τον βρόχο
+    solver_t solver = SOLVER_NONE;   // Επιλυτής μετά τον CSR βρόχο
+    double tol = KRYLOV_TOL;
+    int maxit = KRYLOV_MAXIT;
+    int compact = 0;             // Συμπαγές CSR στη διανομή και στον βρόχο
+    cval_t cvmode = CVAL_AUTO;
+    int grid2d = 0;              // 2D πλέγμα sqrt(P) x sqrt(P) αντί για μπλοκ γραμμών
+    int balance = 0;             // Όρια γραμμών με ~ίσα nnz ανά διεργασία (part.c)
+    int kmax = 0;                // SpMM: k = 1, 2, 4, ..., kmax διανύσματα μετά τον CSR βρόχο
+    int smax = 0;                // Matrix powers: s = 1, ..., smax βήματα ανά ανταλλαγή
+    int hwperf = 0;              // Μετρητές υλικού και roofline των πυρήνων (perf.h)
+    int reps = 1, warmup = 0;    // Harness μετρήσεων (bench.h): επαναλήψεις των βρόχων SpMV
+    const char *results = NULL;
+    int c;
+    while ((c = getopt(argc, argv, "t:wde:of:i:W:r:u:R:ps:E:M:k:m:c:gbH")) != -1) {
+        switch (c) {
+            case 'r': reps = atoi(optarg); break;
+            case 'u': warmup = atoi(optarg); break;
+            case 'R': results = optarg; break;
+            case 'p': reorder = 1; break;
+            case 's':
+                if (strcmp(optarg, "cg") == 0) solver = SOLVER_CG;
+                else if (strcmp(optarg, "pipecg") == 0) solver = SOLVER_PIPECG;
+                else if (strcmp(optarg, "power") == 0) solver = SOLVER_POWER;
+                else optind = -1;
+                break;
+            case 'E': tol = atof(optarg); break;
+            case 'M': maxit = atoi(optarg); break;
+            case 'k': kmax = atoi(optarg); if (kmax < 1) optind = -1; break;
+            case 'm': smax = atoi(optarg); if (smax < 1 || smax > 32) optind = -1; break;
+            case 'c':
+                compact = 1;
+                if (strcmp(optarg, "double") == 0) cvmode = CVAL_DOUBLE;
+                else if (strcmp(optarg, "float") == 0) cvmode = CVAL_FLOAT;
+                else if (strcmp(optarg, "dict") == 0) cvmode = CVAL_DICT;
+                else if (strcmp(optarg, "auto") == 0) cvmode = CVAL_AUTO;
+                else optind = -1;
+                break;
+            case 'i': infile = optarg; break;
+            case 'W': outfile = optarg; break;
+            case 'f':
+                if (strcmp(optarg, "csr") == 0) fmt = FMT_CSR;
+                else if (strcmp(optarg, "sell") == 0) fmt = FMT_SELL;
+                else if (strcmp(optarg, "auto") == 0) fmt = FMT_AUTO;
+                else optind = -1;
+                break;
+            case 'o': overlap = 1; break;
+            case 'e':
+                if (strcmp(optarg, "allgather") == 0) exch = EXCH_ALLGATHER;
+                else if (strcmp(optarg, "halo") == 0) exch = EXCH_HALO;
+                else optind = -1;
+                break;
+            case 't': nthreads = atoi(optarg); break;
+            case 'd': distgen = 1; break;
+            case 'g': grid2d = 1; break;
+            case 'b': balance = 1; break;
+            case 'H': hwperf = 1; break;
+            case 'w': shared = 1; break;
+            default: optind = -1; break;
+        }
+        if (optind < 0) break;
+    }
+
+    if (optind < 0 || argc - optind != (infile ? 1 : 3) || (overlap && shared) ||
+        (overlap && fmt == FMT_SELL) || (infile && distgen) || (compact && (overlap || fmt != FMT_CSR)) ||
+        (grid2d && (shared || overlap || exch != EXCH_ALLGATHER || fmt != FMT_CSR || compact ||
+                    reorder || solver != SOLVER_NONE || kmax > 0 || smax > 0)) || (balance && (shared || grid2d)) ||
+        (hwperf && (overlap || grid2d))) {
+        if (my_rank == 0) {
+            printf("Usage: %s [-t threads] [-w | -o | -g] [-d] [-b] [-e allgather|halo] [-f csr|sell|auto] [-p]\n"
+                   "          [-c double|float|dict|auto] [-s cg|pipecg|power] [-E tol] [-M maxit]\n"
+                   "          [-k kmax] [-m smax] [-H] [-W out.bin] [-r reps] [-u warmup] [-R results.csv|.json]\n"
+                   "          <n> <sparsity> <iters>\n"
+                   "       %s [options] -i matrix.mtx|matrix.bin <iters>\n", argv[0], argv[0]);
+            printf("  -t  OpenMP threads per MPI rank (default: 1)\n");
+            printf("  -w  one shared copy of x per node (MPI-3 shared windows)\n");
+            printf("  -d  distributed generation: each rank builds its rows directly in CSR\n"
+                   "      (counter-based RNG, same matrix for any P, no global dense matrix)\n");
+            printf("  -b  nnz-balanced row partition: row ranges cut on the prefix sums of row_ptr\n"
+                   "      (default: n / P rows per rank; not with -w or -g)\n");
+            printf("  -e  x update in the CSR loop: allgather (default) or halo (ghost entries only)\n");
+            printf("  -o  overlap the (non-blocking) x update with the rows that need only local x\n");
+            printf("  -g  2D sqrt(P) x sqrt(P) process grid for CSR and Dense: y reduced across grid\n"
+                   "      rows, x broadcast down grid columns (P square; only with -d, -i, -t, -r)\n");
+            printf("  -f  sparse format: csr (default), sell (SELL-C-sigma, SIMD) or auto\n"
+                   "      (auto picks csr, sell or dense from nnz/row and row-length variance)\n");
+            printf("  -c  compact CSR in the scatter and the loop: 16-bit column deltas and\n"
+                   "      double / float / dict (8-bit index, <= %d distinct) values; auto picks\n"
+                   "      dict, then float if exact, then double (not with -o or -f); the Master\n"
+                   "      then builds the whole CSR itself (otherwise each rank converts its dense rows)\n",
+                   CCSR_DICT_MAX);
+            printf("  -i  load the matrix from a Matrix Market (coordinate) or binary CSR file\n"
+                   "      (parallel MPI-IO: each rank reads its part, x = ones)\n");
+            printf("  -W  save the distributed matrix as binary CSR (reload with -i)\n");
+            printf("  -p  reorder rows/columns with Reverse Cuthill-McKee before the CSR loop\n"
+                   "      (reports bandwidth, profile and SpMV time before / after)\n");
+            printf("  -s  also run a solver on the distributed CSR matrix:\n"
+                   "      cg / pipecg (SPD A, b = A*1; pipecg overlaps one Iallreduce with the SpMV)\n"
+                   "      or power (normalized power iteration, dominant eigenvalue)\n");
+            printf("  -E  solver tolerance on the relative residual (default: %.0e)\n", KRYLOV_TOL);
+            printf("  -M  solver iteration limit (default: %d)\n", KRYLOV_MAXIT);
+            printf("  -k  also run the loop as SpMM on k = 1, 2, 4, ..., kmax vectors at once\n"
+                   "      (one exchange of all k vectors per iteration, GFLOP/s vs k)\n");
+            printf("  -m  also run the loop as s-step matrix powers for s = 1, ..., smax (<= 32):\n"
+                   "      one exchange of the depth-s ghost region per s iterations, ghost rows\n"
+                   "      computed redundantly (messages saved vs extra flops per s)\n");
+            printf("  -H  hardware counters (perf_event_open: cycles, instructions, LLC misses) around\n"
+                   "      the CSR and Dense kernels, GFLOP/s and GB/s vs a STREAM triad ceiling\n"
+                   "      (not with -o or -g)\n");
+            printf("  -r  timed repetitions of the CSR / Dense loops (default: 1), each from x = x0;\n"
+                   "      reported loop times are medians over them\n");
+            printf("  -u  untimed warm-up repetitions (default: 0)\n");
+            printf("  -R  append min/median/max over reps and ranks to a CSV (or .json) file\n");
+        }
         MPI_Finalize(); return 0;
     }
 
-    n = atoi(argv[1]);
-    sparsity = atof(argv[2]);
-    iters = atoi(argv[3]);
+    long long file_nnz = 0;
+    if (infile) {
+        if (csr_file_dims(infile, MPI_COMM_WORLD, &n, &file_nnz) != 0) {
+            if (my_rank == 0) printf("Error: cannot read matrix file %s\n", infile);
+            MPI_Finalize(); return 0;
+        }
+        sparsity = 0.0;            // Υπολογίζεται μετά τη φόρτωση
+        iters = atoi(argv[optind]);
+    } else {
+        n = atoi(argv[optind]);
+        sparsity = atof(argv[optind + 1]);
+        iters = atoi(argv[optind + 2]);
+    }
+
+    if (nthreads < 1) nthreads = 1;
+    omp_set_num_threads(nthreads);
 
-    if (n % comm_sz != 0) {
-        if (my_rank == 0) printf("Error: n must be divisible by P\n");
+    if (n < comm_sz) {
+        if (my_rank == 0) printf("Error: n must be at least P\n");
+        MPI_Finalize(); return 0;
+    }
+    grid2d_t grid;
+    if (grid2d && grid2d_create(&grid, n, MPI_COMM_WORLD) != 0) {
+        if (my_rank == 0) printf("Error: -g needs P to be a perfect square and n divisible by sqrt(P)\n");
         MPI_Finalize(); return 0;
     }
 
@@ -95,185 +213,871 @@ int main(int argc, char* argv[]) {
     double *x = NULL;          // Τοπικό διάνυσμα x (ανανεώνεται σε κάθε iter)
     double *x_copy = NULL;     // Backup για χρήση στο Dense μέρος
     csr_t global_csr;
+    csr_t local_csr;           // Οι γραμμές της διεργασίας (τοπικό row_ptr)
+    ccsr_t global_cc, cc;      // Συμπαγές CSR: του Master (διανομή) και τοπικό (βρόχος)
+    double t_cc_enc_start = 0.0, t_cc_enc_end = 0.0, cc_scatter_bytes = 0.0;
+
+    // Μπλοκ κατανομή γραμμών: η διεργασία r κατέχει [row_off[r], row_off[r+1])
+    // (ομοιόμορφη: n / P γραμμές, +1 στις πρώτες n % P. Με -b τα όρια
+    // ξανακόβονται μετά την κατασκευή του CSR, ώστε να ισοκατανεμηθούν τα nnz)
+    int *row_off = (int*) malloc((comm_sz + 1) * sizeof(int));
+    part_uniform(n, comm_sz, row_off);
+    int local_n = row_off[my_rank + 1] - row_off[my_rank]; // Γραμμές της διεργασίας
+
+    // Πίνακας του Master: το CSR φτιάχνεται παράλληλα από τις dense γραμμές κάθε
+    // διεργασίας (pconv). Μόνο με -c ο Master φτιάχνει όλο το CSR, γιατί η συμπαγής
+    // διανομή στέλνει τη δική του κωδικοποίηση.
+    int master_csr = !distgen && !infile && compact;
+    int pconv = !distgen && !infile && !compact;
+    double imb_uniform = 1.0, imb_balanced = 1.0;          // max / mean nnz ανά διεργασία
+    double t_part_start = 0.0, t_part_end = 0.0;
 
     // Δέσμευση χώρου για το διάνυσμα x σε όλες τις διεργασίες
-    x = (double*) malloc(n * sizeof(double));
-    x_copy = (double*) malloc(n * sizeof(double));
+    // (shared: ένα κοινό παράθυρο ανά κόμβο, βλ. shm.c)
+    shm_vec_t xs;
+    if (shared) {
+        shm_vec_create(&xs, n, row_off);
+    } else {
+        x = (double*) malloc(n * sizeof(double));
+        x_copy = (double*) malloc(n * sizeof(double));
+    }
 
-    if (my_rank == 0) {
+    if (my_rank == 0 && infile) {
+        printf("All ranks: Loading N=%d from %s (MPI-IO)...\n", n, infile);
+        x_global = (double*) malloc(n * sizeof(double));
+        for(int i=0; i<n; i++) x_global[i] = 1.0; // Αρχικοποίηση x με 1
+        if (!shared) memcpy(x, x_global, n * sizeof(double));
+    } else if (my_rank == 0 && distgen) {
+        printf("All ranks: Generating N=%d, Sparsity=%.2f (counter-based RNG)...\n", n, sparsity);
+        x_global = (double*) malloc(n * sizeof(double));
+        for(int i=0; i<n; i++) x_global[i] = 1.0; // Αρχικοποίηση x με 1
+        if (!shared) memcpy(x, x_global, n * sizeof(double));
+    } else if (my_rank == 0) {
         printf("Master: Generating N=%d, Sparsity=%.2f...\n", n, sparsity);
-        A_dense_global = (double*) malloc(n * n * sizeof(double));
+        A_dense_global = (double*) malloc((size_t) n * n * sizeof(double));
         x_global = (double*) malloc(n * sizeof(double));
 
         // Τυχαία αρχικοποίηση με βάση το sparsity
         srand(42);
-        for(int i=0; i<n*n; i++) {
+        for(size_t i=0; i<(size_t) n*n; i++) {
             double r = (double)rand() / RAND_MAX;
             A_dense_global[i] = (r > sparsity) ? ((rand()%10)+1) : 0.0;
         }
         for(int i=0; i<n; i++) x_global[i] = 1.0; // Αρχικοποίηση x με 1
 
-        memcpy(x, x_global, n * sizeof(double));
-
+        if (!shared) memcpy(x, x_global, n * sizeof(double));
+    }
+    if (my_rank == 0 && master_csr) {
         // (i) Κατασκευή CSR και Χρονομέτρηση
         GET_TIME(t_csr_create_start);
         global_csr = dense2csr(A_dense_global, n);
         GET_TIME(t_csr_create_end);
     }
+    // Ο Master κρατά όλο το CSR: πάνω από 2^31 - 1 μη-μηδενικά το dense2csr δίνει nnz < 0
+    if (master_csr) {
+        int fits = my_rank != 0 || global_csr.nnz >= 0;
+        MPI_Bcast(&fits, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (!fits) {
+            if (my_rank == 0) printf("Error: the Master CSR holds more than 2^31 - 1 nonzeros (drop -c)\n");
+            MPI_Finalize(); return 0;
+        }
+    }
+    if (my_rank == 0 && master_csr) {
+        // -b: νέα όρια από το row_ptr του Master (πριν τη συμπαγή μορφή, που
+        // κόβει τα chunks σε αυτά). Τα μαθαίνουν οι υπόλοιποι στη φάση 2.
+        imb_uniform = part_imbalance(global_csr.row_ptr, row_off, comm_sz);
+        if (balance) {
+            GET_TIME(t_part_start);
+            part_nnz(&global_csr, 0, n, comm_sz, MPI_COMM_SELF, row_off);
+            GET_TIME(t_part_end);
+            imb_balanced = part_imbalance(global_csr.row_ptr, row_off, comm_sz);
+        }
+
+        // Συμπαγής μορφή για τη διανομή (chunks κομμένα στα όρια των διεργασιών)
+        GET_TIME(t_cc_enc_start);
+        global_cc = ccsr_encode(&global_csr, row_off, comm_sz, cvmode);
+        GET_TIME(t_cc_enc_end);
+        cc_scatter_bytes = ccsr_bytes(&global_cc);
+    }
+
+    // (i) distgen: κάθε διεργασία φτιάχνει απευθείας το CSR των γραμμών της.
+    // Χρόνος δημιουργίας = ο χρόνος της πιο αργής διεργασίας.
+    if (distgen) {
+        double t0, t1, t_gen, t_gen_max;
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t0);
+        local_csr = gen_csr_rows(n, row_off[my_rank], row_off[my_rank + 1], sparsity, GEN_SEED);
+        GET_TIME(t1);
+        t_gen = t1 - t0;
+        MPI_Reduce(&t_gen, &t_gen_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (my_rank == 0) t_csr_create_end = t_gen_max;
+    }
+
+    // (i) Αρχείο: κάθε διεργασία διαβάζει τις γραμμές της (ο χρόνος της πιο αργής).
+    double *local_A_dense = NULL;
+    int run_dense = 1;
+    if (infile) {
+        double t0, t1, t_load, t_load_max;
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t0);
+        local_csr = csr_load(infile, row_off, MPI_COMM_WORLD);
+        GET_TIME(t1);
+        if (local_csr.nnz < 0) {
+            if (my_rank == 0) printf("Error: cannot read matrix file %s\n", infile);
+            MPI_Finalize(); return 0;
+        }
+        t_load = t1 - t0;
+        MPI_Reduce(&t_load, &t_load_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (my_rank == 0) t_csr_create_end = t_load_max;
+
+        long long nnz_loc = local_csr.nnz, nnz_tot;
+        MPI_Allreduce(&nnz_loc, &nnz_tot, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+        sparsity = 1.0 - (double) nnz_tot / ((double) n * n);
+    }
 
     // Διανομή του αρχικού διανύσματος x σε όλους
-    MPI_Bcast(x, n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-    memcpy(x_copy, x, n * sizeof(double)); // Backup για το Dense πείραμα
+    if (shared) {
+        shm_vec_bcast(&xs, x_global);
+        x = shm_vec_x(&xs);
+    } else {
+        MPI_Bcast(x, n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        memcpy(x_copy, x, n * sizeof(double)); // Backup για το Dense πείραμα
+    }
 
 
     /* ======================================================
        PHASE 2: CSR DISTRIBUTION & CALCULATION
        ====================================================== */
-    int local_n = n / comm_sz; // Γραμμές ανά διεργασία
-    int local_nnz;             // Μη-μηδενικά ανά διεργασία (διαφέρει στον καθένα)
-    
-    // Πίνακες για το Scatterv (διαχειρίζονται τα άνισα μεγέθη δεδομένων)
-    int *scounts = NULL, *displs = NULL;
-
-    if (my_rank == 0) {
-        scounts = malloc(comm_sz * sizeof(int));
-        displs = malloc(comm_sz * sizeof(int));
-        
-        // Υπολογισμός κατανομής φορτίου (nnz) ανά διεργασία
-        for (int i=0; i<comm_sz; i++) {
-            int start = i * local_n;
-            int end = (i+1) * local_n;
-            scounts[i] = global_csr.row_ptr[end] - global_csr.row_ptr[start];
-            displs[i] = global_csr.row_ptr[start];
-        }
+    // -b με το CSR του Master: τα όρια υπολογίστηκαν στη φάση 1
+    if (balance && master_csr) {
+        MPI_Bcast(row_off, comm_sz + 1, MPI_INT, 0, MPI_COMM_WORLD);
+        local_n = row_off[my_rank + 1] - row_off[my_rank];
     }
 
     MPI_Barrier(MPI_COMM_WORLD);
     GET_TIME(t_csr_comm_start);
 
-    // 1. Ενημέρωση διεργασιών για το μέγεθος δεδομένων που θα λάβουν (local_nnz)
-    MPI_Scatter(scounts, 1, MPI_INT, &local_nnz, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
-    // 2. Δέσμευση Τοπικής Μνήμης CSR
-    csr_t local_csr;
-    local_csr.n = local_n;
-    local_csr.nnz = local_nnz;
-    local_csr.values = malloc(local_nnz * sizeof(double));
-    local_csr.col_ind = malloc(local_nnz * sizeof(int));
-    local_csr.row_ptr = malloc((local_n + 1) * sizeof(int));
-
-    // 3. Διανομή δεδομένων (Χρήση Scatterv λόγω ανισοκατανομής των μηδενικών)
-    MPI_Scatterv(my_rank==0 ? global_csr.values : NULL, scounts, displs, MPI_DOUBLE, 
-                 local_csr.values, local_nnz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-    MPI_Scatterv(my_rank==0 ? global_csr.col_ind : NULL, scounts, displs, MPI_INT, 
-                 local_csr.col_ind, local_nnz, MPI_INT, 0, MPI_COMM_WORLD);
-    
-    // 4. Διανομή row_ptr (Χρήση απλού Scatter καθώς κάθε διεργασία έχει ίδιο αριθμό γραμμών)
-    MPI_Scatter(my_rank==0 ? global_csr.row_ptr : NULL, local_n, MPI_INT,
-                local_csr.row_ptr, local_n, MPI_INT, 0, MPI_COMM_WORLD);
-
-    // 5. Normalization: Διόρθωση των δεικτών row_ptr ώστε να είναι τοπικοί (0-based)
-    int start_idx = local_csr.row_ptr[0];
-    for(int i=0; i<local_n; i++) local_csr.row_ptr[i] -= start_idx;
-    local_csr.row_ptr[local_n] = local_nnz; // Τελευταίο στοιχείο = συνολικά στοιχεία
+    // Συμπαγής (-c): διανομή της συμπαγούς μορφής του Master και αποκωδικοποίηση (μέρος της φάσης).
+    // Αλλιώς ο Master στέλνει τις dense γραμμές (Scatterv σε μονάδες γραμμών) και το CSR
+    // φτιάχνεται παρακάτω από όλες τις διεργασίες. distgen / αρχείο: κάθε διεργασία έχει ήδη
+    // τις γραμμές της.
+    if (master_csr) {
+        ccsr_t part = ccsr_scatter(&global_cc, row_off, MPI_COMM_WORLD);
+        local_csr = ccsr_decode(&part);
+        free_ccsr(&part);
+    } else if (pconv) {
+        int *cnt = part_counts(row_off, comm_sz);
+        MPI_Datatype row_t;
+        MPI_Type_contiguous(n, MPI_DOUBLE, &row_t);
+        MPI_Type_commit(&row_t);
+        local_A_dense = (double*) malloc((size_t) local_n * n * sizeof(double));
+        MPI_Scatterv(A_dense_global, cnt, row_off, row_t, local_A_dense, local_n, row_t, 0, MPI_COMM_WORLD);
+        MPI_Type_free(&row_t);
+        free(cnt);
+    }
 
     MPI_Barrier(MPI_COMM_WORLD);
     GET_TIME(t_csr_comm_end);
 
+    // (i) Παράλληλη μετατροπή: κάθε διεργασία μετατρέπει το dense μπλοκ της (με T νήματα).
+    // Χρόνος δημιουργίας = ο χρόνος της πιο αργής διεργασίας.
+    if (pconv) {
+        double t0, t1, t_conv, t_conv_max;
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t0);
+        local_csr = dense2csr_rows(local_A_dense, local_n, n);
+        GET_TIME(t1);
+        t_conv = t1 - t0;
+        MPI_Reduce(&t_conv, &t_conv_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (my_rank == 0) t_csr_create_end = t_conv_max;
+
+        int fits = local_csr.nnz >= 0;
+        MPI_Allreduce(MPI_IN_PLACE, &fits, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        if (!fits) {
+            if (my_rank == 0) printf("Error: a rank holds more than 2^31 - 1 nonzeros (use more ranks)\n");
+            MPI_Finalize(); return 0;
+        }
+        // 2D: το Dense πείραμα παίρνει τα μπλοκ A_ij από τον Master στη φάση 3
+        if (grid2d) { free(local_A_dense); local_A_dense = NULL; }
+    }
+
+    // -b με κατανεμημένες γραμμές (distgen / αρχείο / παράλληλη μετατροπή): τα όρια
+    // βρίσκονται συλλογικά και οι γραμμές μετακινούνται στους νέους ιδιοκτήτες
+    if (!master_csr) {
+        imb_uniform = imb_balanced = part_imbalance_dist(&local_csr, MPI_COMM_WORLD);
+        if (balance) {
+            int *new_off = (int*) malloc((comm_sz + 1) * sizeof(int));
+            MPI_Barrier(MPI_COMM_WORLD);
+            GET_TIME(t_part_start);
+            part_nnz(&local_csr, row_off[my_rank], n, comm_sz, MPI_COMM_WORLD, new_off);
+            csr_t moved = part_redistribute(&local_csr, row_off[my_rank], new_off, MPI_COMM_WORLD);
+            MPI_Barrier(MPI_COMM_WORLD);
+            GET_TIME(t_part_end);
+            free_csr(&local_csr);
+            local_csr = moved;
+            memcpy(row_off, new_off, (comm_sz + 1) * sizeof(int));
+            free(new_off);
+            imb_balanced = part_imbalance_dist(&local_csr, MPI_COMM_WORLD);
+            // Οι dense γραμμές του Dense πειράματος ακολουθούν τα νέα όρια
+            if (local_A_dense) {
+                free(local_A_dense);
+                local_A_dense = csr_to_dense_rows(&local_csr, n);
+            }
+        }
+    }
+    local_n = row_off[my_rank + 1] - row_off[my_rank];
+    int *row_cnt = part_counts(row_off, comm_sz);   // counts των Allgatherv / Scatterv
+
+    // Αρχείο: το Dense πείραμα χρειάζεται τις ίδιες γραμμές σε dense μορφή: τις
+    // φτιάχνουμε τώρα, πριν το halo επαναριθμήσει τις στήλες του CSR. Το όριο
+    // μεγέθους κρίνεται από το μεγαλύτερο μπλοκ, ώστε να συμφωνούν όλες οι διεργασίες.
+    if (infile) {
+        int max_n = 0;
+        for (int r = 0; r < comm_sz; r++) if (row_cnt[r] > max_n) max_n = row_cnt[r];
+        run_dense = (size_t) max_n * n * sizeof(double) <= (size_t) DENSE_MAX_BYTES;
+        if (run_dense && !grid2d) local_A_dense = csr_to_dense_rows(&local_csr, n);
+    }
+
+    // Αποθήκευση σε binary CSR (εκτός χρονομέτρησης, πριν την επαναρίθμηση του halo)
+    if (outfile) {
+        int rc = csr_save(outfile, &local_csr, row_off, MPI_COMM_WORLD);
+        if (my_rank == 0) {
+            if (rc == 0) printf("Saved matrix to %s (binary CSR)\n", outfile);
+            else printf("Warning: cannot write %s\n", outfile);
+        }
+    }
+
+    // 2D: ανακατανομή των γραμμών στα μπλοκ A_ij (χρονομετρείται ως στάδιο)
+    csr_t blk_csr;
+    double t_grid_start = 0.0, t_grid_end = 0.0;
+    if (grid2d) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_grid_start);
+        blk_csr = grid2d_csr(&grid, &local_csr, row_off[my_rank]);
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_grid_end);
+    }
+
+    // RCM: B = P A P^T πριν το halo (οι στήλες είναι ακόμα global). Η αναδιάταξη
+    // χρονομετρείται ως ξεχωριστό στάδιο. Τα probes πριν / μετά μετρούν λίγες
+    // επαναλήψεις SpMV για να φανεί πότε το κόστος αποσβένεται.
+    int *perm = NULL;
+    double t_rcm_start = 0.0, t_rcm_end = 0.0, probe_before = 0.0, probe_after = 0.0;
+    rcm_stats_t rcm_before = { 0, 0 }, rcm_after = { 0, 0 };
+    long long ghosts_before = 0, ghosts_after = 0;
+    if (reorder) {
+        rcm_before = rcm_stats(&local_csr, row_off[my_rank], MPI_COMM_WORLD);
+        probe_before = rcm_probe(&local_csr, exch, row_off, n, MPI_COMM_WORLD, &ghosts_before);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_rcm_start);
+        perm = rcm_order(&local_csr, row_off, n, MPI_COMM_WORLD);
+        csr_t reordered = rcm_permute(&local_csr, row_off, perm, n, MPI_COMM_WORLD);
+        free(local_csr.values); free(local_csr.col_ind); free(local_csr.row_ptr);
+        local_csr = reordered;
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_rcm_end);
+
+        rcm_after = rcm_stats(&local_csr, row_off[my_rank], MPI_COMM_WORLD);
+        probe_after = rcm_probe(&local_csr, exch, row_off, n, MPI_COMM_WORLD, &ghosts_after);
+    }
+
+    // Matrix powers: το setup χρειάζεται τις global στήλες (το halo τις επαναριθμεί)
+    int *mpk_cols = NULL;
+    if (smax > 0) {
+        mpk_cols = (int*) malloc((local_csr.nnz + 1) * sizeof(int));
+        memcpy(mpk_cols, local_csr.col_ind, local_csr.nnz * sizeof(int));
+    }
+
+    // Halo: σχέδιο ανταλλαγής και επαναρίθμηση στηλών (εκτός βρόχου, χρονομετρείται χωριστά)
+    halo_t halo;
+    double *x_loc = NULL;      // Halo: [δικά μας στοιχεία | ghosts]
+    double t_halo_start = 0.0, t_halo_end = 0.0;
+    if (exch == EXCH_HALO) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_halo_start);
+        halo_setup(&halo, &local_csr, row_off, MPI_COMM_WORLD);
+        x_loc = (double*) malloc((local_n + halo.nghost) * sizeof(double));
+        halo_init_x(&halo, x, row_off[my_rank], x_loc);
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_halo_end);
+    }
+
+    // Όγκος επικοινωνίας ανά επανάληψη (bytes που λαμβάνει κάθε διεργασία)
+    // (2D: το μερικό y_i στη γραμμή και το x_j στη στήλη, nb στοιχεία το καθένα)
+    double recv_bytes = exch == EXCH_HALO ? (double) halo.nghost * sizeof(double) :
+                        grid2d ? 2.0 * grid.nb * sizeof(double) :
+                        (double) (n - local_n) * sizeof(double);
+    double vol_total, vol_max;
+    MPI_Reduce(&recv_bytes, &vol_total, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&recv_bytes, &vol_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    int nbr_max = exch == EXCH_HALO ? halo.nrecv : grid2d ? 2 * (grid.q - 1) : comm_sz - 1;
+    MPI_Allreduce(MPI_IN_PLACE, &nbr_max, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+    // Μορφή του sparse πυρήνα (μετά το halo: οι δείκτες στηλών είναι τελικοί)
+    fmt_stats_t fst = { 0.0, 0.0, 0.0, 0.0 };
+    fmt_t chosen = fmt;
+    sell_t sell;
+    double t_sell_start = 0.0, t_sell_end = 0.0;
+    if (fmt != FMT_CSR) {
+        fmt_t pick = fmt_select(&local_csr, n, SELL_SIGMA, MPI_COMM_WORLD, &fst);
+        if (fmt == FMT_AUTO) chosen = pick;
+    }
+    // Το overlap χρησιμοποιεί λίστες γραμμών CSR. Με επιλογή dense, η CSR φάση
+    // τρέχει ως σύγκριση και η επιλογή αφορά το Dense path.
+    int use_sell = chosen == FMT_SELL && !overlap;
+    if (use_sell) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_sell_start);
+        sell = csr2sell(&local_csr, SELL_SIGMA);
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_sell_end);
+    }
+
+    // Συμπαγές CSR του βρόχου: κωδικοποίηση μετά το halo (τελικές στήλες) και
+    // σύγκριση bytes / nnz και χρόνου ανά SpMV με το CSR
+    double t_cc_start = 0.0, t_cc_end = 0.0, cc_t_csr = 0.0, cc_t_ccsr = 0.0;
+    double cc_bytes[3] = { 0.0, 0.0, 0.0 };   // Συμπαγές, CSR, nnz (global)
+    int cc_exact = 1;
+    if (compact) {
+        int blk[2] = { 0, local_n };
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_cc_start);
+        cc = ccsr_encode(&local_csr, blk, 1, ccsr_vmode(&local_csr, cvmode, MPI_COMM_WORLD));
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_cc_end);
+
+        cc_bytes[0] = ccsr_bytes(&cc);
+        cc_bytes[1] = (double) local_csr.nnz * (sizeof(double) + sizeof(int)) + (local_n + 1) * sizeof(int);
+        cc_bytes[2] = local_csr.nnz;
+        MPI_Allreduce(MPI_IN_PLACE, cc_bytes, 3, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        if (cc.vmode == CVAL_FLOAT) cc_exact = ccsr_float_exact(&local_csr);
+        MPI_Allreduce(MPI_IN_PLACE, &cc_exact, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        ccsr_compare(&local_csr, &cc, exch == EXCH_HALO ? x_loc : x, MPI_COMM_WORLD, &cc_t_csr, &cc_t_ccsr);
+    }
+
+    // Overlap: interior / boundary γραμμές και χρόνος αναφοράς μίας ανασταλτικής ανταλλαγής
+    ovl_split_t split;
+    ovl_times_t ovl_csr, ovl_dense;
+    double t_exch_csr = 0.0, t_exch_dense = 0.0;
+    int lo = row_off[my_rank];
+    if (overlap) {
+        if (exch == EXCH_HALO) ovl_split(&split, &local_csr, 0, local_n);
+        else ovl_split(&split, &local_csr, lo, lo + local_n);
+        t_exch_csr = ovl_calibrate(exch, &halo, exch == EXCH_HALO ? x_loc : x, n, row_off);
+    }
+
+    // Harness: οι φάσεις δημιουργίας / διανομής μετρώνται μία φορά (κόστος
+    // εγκατάστασης), οι βρόχοι SpMV επαναλαμβάνονται.
+    bench_t bench;
+    bench_init(&bench, "ex3_2", reps, warmup);
+    int ph_csr_calc = bench_phase(&bench, "csr_calc");
+    int ph_csr_work = bench_phase(&bench, "csr_work");
+    int ph_dense_calc = bench_phase(&bench, "dense_calc");
+    int ph_dense_work = bench_phase(&bench, "dense_work");
+    int ph_solve = solver != SOLVER_NONE ? bench_phase(&bench, "solve") : -1;
+    int ph_spmm = kmax > 0 ? bench_phase(&bench, "spmm") : -1;   // k = kmax
+    int ph_mpk = smax > 0 ? bench_phase(&bench, "mpk") : -1;      // s = smax
+
+    // Μετρητές υλικού (-H): μόνο ο πυρήνας κάθε επανάληψης, χωρίς την ανταλλαγή.
+    // Πράξεις: 2 ανά μη-μηδενικό (SELL: χωρίς το συμπλήρωμα), 2 ανά στοιχείο στο Dense.
+    perf_t pf;
+    perf_init(&pf, hwperf);
+    int pf_csr = perf_region(&pf, "csr"), pf_dense = perf_region(&pf, "dense");
+    double csr_flops = 2.0 * local_csr.nnz, csr_bytes = 0.0;
+    double dense_flops = 2.0 * local_n * n;
+    double dense_bytes = ((double) local_n * n + n + local_n) * sizeof(double);
+    if (hwperf) {
+        double mat = use_sell ? (double) sell.nnz_stored * (sizeof(double) + sizeof(int)) +
+                                (double) sell.nchunks * 2 * sizeof(int) + (double) sell.n * sizeof(int)
+                   : compact ? (double) ccsr_bytes(&cc)
+                   : (double) local_csr.nnz * (sizeof(double) + sizeof(int)) + (local_n + 1.0) * sizeof(int);
+        csr_bytes = spmv_bytes(&local_csr, mat, exch == EXCH_HALO ? local_n + halo.nghost : n);
+    }
+
     // 6. Κύριος Βρόχος Υπολογισμού CSR (SpMV Kernel)
     double *local_y = calloc(local_n, sizeof(double)); // Τοπικό αποτέλεσμα
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    GET_TIME(t_csr_calc_start);
-
-    for (int iter = 0; iter < iters; iter++) {
-        // Υπολογισμός y = A * x (μόνο για τα μη-μηδενικά)
-        for (int i = 0; i < local_n; i++) {
-            double sum = 0.0;
-            // Διασχίζουμε μόνο τα στοιχεία που υπάρχουν (αποδοτικότητα CSR)
-            for (int j = local_csr.row_ptr[i]; j < local_csr.row_ptr[i+1]; j++) {
-                sum += local_csr.values[j] * x[local_csr.col_ind[j]];
+    // Αρχικό x του CSR βρόχου: με RCM στη νέα αρίθμηση, x0'[k] = x0[perm[k]]
+    const double *x0_csr = shared ? x_global : x_copy;
+    double *x0_perm = NULL;
+    if (reorder && (!shared || my_rank == 0)) {
+        x0_perm = (double*) malloc(n * sizeof(double));
+        for (int k = 0; k < n; k++) x0_perm[k] = x0_csr[perm[k]];
+        x0_csr = x0_perm;
+    }
+    double *x0_spmm = kmax > 0 || smax > 0 ? (double*) malloc(n * sizeof(double)) : NULL;
+
+    for (int rep = -bench.warmup; rep < bench.reps; rep++) {
+        // Κάθε επανάληψη μέτρησης ξεκινά από το αρχικό x
+        if (shared) { shm_vec_bcast(&xs, x0_csr); x = shm_vec_x(&xs); }
+        else memcpy(x, x0_csr, n * sizeof(double));
+        if (exch == EXCH_HALO) halo_init_x(&halo, x, lo, x_loc);
+        if (x0_spmm && rep == -bench.warmup) memcpy(x0_spmm, x, n * sizeof(double));
+        double t_work = 0.0, t_k0, t_k1;   // Τοπικός χρόνος πυρήνα (χωρίς επικοινωνία)
+        if (rep == 0) perf_reset(&pf, pf_csr);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_csr_calc_start);
+
+        if (overlap)
+            ovl_csr_loop(&local_csr, &split, exch, &halo, exch == EXCH_HALO ? x_loc : x, row_off, iters, local_y, &ovl_csr);
+        if (grid2d) t_work = grid2d_csr_loop(&grid, &blk_csr, x, iters);
+
+        for (int iter = 0; iter < iters && !overlap && !grid2d; iter++) {
+            // Halo: οι στήλες είναι επαναριθμημένες ως προς το x_loc
+            const double *xk = exch == EXCH_HALO ? x_loc : x;
+
+            // Υπολογισμός y = A * x (μόνο για τα μη-μηδενικά)
+            // Hybrid: τα νήματα μοιράζονται τις γραμμές (guided λόγω άνισου nnz ανά γραμμή)
+            perf_start(&pf, pf_csr);
+            GET_TIME(t_k0);
+            if (use_sell) sell_spmv(&sell, xk, local_y);
+            else if (compact) ccsr_spmv(&cc, xk, local_y);
+            else {
+                #pragma omp parallel for schedule(guided)
+                for (int i = 0; i < local_n; i++) {
+                    double sum = 0.0;
+                    // Διασχίζουμε μόνο τα στοιχεία που υπάρχουν (αποδοτικότητα CSR)
+                    for (int j = local_csr.row_ptr[i]; j < local_csr.row_ptr[i+1]; j++) {
+                        sum += local_csr.values[j] * xk[local_csr.col_ind[j]];
+                    }
+                    local_y[i] = sum;
+                }
+            }
+            GET_TIME(t_k1);
+            perf_stop(&pf, pf_csr, t_k1 - t_k0, csr_flops, csr_bytes);
+            t_work += t_k1 - t_k0;
+            // Συλλογή αποτελεσμάτων και ανανέωση του x για την επόμενη επανάληψη
+            if (exch == EXCH_HALO) {
+                memcpy(x_loc, local_y, local_n * sizeof(double));
+                halo_exchange(&halo, x_loc);
+            } else if (shared) {
+                shm_vec_exchange(&xs, local_y);
+                x = shm_vec_x(&xs);
+            } else {
+                MPI_Allgatherv(local_y, local_n, MPI_DOUBLE, x, row_cnt, row_off, MPI_DOUBLE, MPI_COMM_WORLD);
             }
-            local_y[i] = sum;
         }
-        // Συλλογή αποτελεσμάτων και ανανέωση του x για την επόμενη επανάληψη
-        MPI_Allgather(local_y, local_n, MPI_DOUBLE, x, local_n, MPI_DOUBLE, MPI_COMM_WORLD);
+        GET_TIME(t_k0);
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_csr_calc_end);
+        if (overlap) t_work = t_k0 - t_csr_calc_start - ovl_csr.wait;
+        bench_record(&bench, ph_csr_calc, rep, t_csr_calc_end - t_csr_calc_start);
+        bench_record(&bench, ph_csr_work, rep, t_work);
+    }
+
+    // Επιλυτής στον ίδιο κατανεμημένο πίνακα (ίδια μορφή και ανταλλαγή με τον βρόχο)
+    krylov_result_t kres;
+    if (solver != SOLVER_NONE) {
+        for (int rep = -bench.warmup; rep < bench.reps; rep++) {
+            krylov_solve(solver, &local_csr, use_sell ? &sell : NULL, exch, &halo, row_off,
+                         maxit, tol, MPI_COMM_WORLD, &kres);
+            bench_record(&bench, ph_solve, rep, kres.time);
+        }
+    }
+
+    // SpMM: ο ίδιος βρόχος με k διανύσματα (CSR πυρήνας, ίδια ανταλλαγή). Κάθε k
+    // επαναλαμβάνεται όπως οι βρόχοι· κρατάμε τη median της πιο αργής διεργασίας.
+    int nk = 0;
+    spmm_result_t spmm_res[32];
+    double spmm_time[32];
+    long long nnz_total = local_csr.nnz;
+    MPI_Allreduce(MPI_IN_PLACE, &nnz_total, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    if (kmax > 0) {
+        const double *y_ref = exch == EXCH_HALO ? x_loc : x + lo;
+        double *t_rep = (double*) malloc(bench.reps * sizeof(double));
+        for (int k = 1; ; k = k * 2 < kmax ? k * 2 : kmax) {   // Το πολύ 32 τιμές του k
+            for (int rep = -bench.warmup; rep < bench.reps; rep++) {
+                spmm_run(&local_csr, exch, &halo, row_off, k, iters, x0_spmm, y_ref, MPI_COMM_WORLD, &spmm_res[nk]);
+                if (rep >= 0) t_rep[rep] = spmm_res[nk].time;
+                if (k == kmax) bench_record(&bench, ph_spmm, rep, spmm_res[nk].time);
+            }
+            MPI_Allreduce(MPI_IN_PLACE, t_rep, bench.reps, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+            spmm_time[nk++] = bench_median(t_rep, bench.reps);
+            if (k == kmax) break;
+        }
+        free(t_rep);
+    }
+
+    // Matrix powers: για κάθε s setup (χρονομετρείται χωριστά) και ο βρόχος με
+    // μία ανταλλαγή ανά s επαναλήψεις, από το ίδιο x0 με τον CSR βρόχο
+    int ns = 0;
+    mpk_result_t mpk_res[32];
+    double mpk_time[32], mpk_setup_time[32];
+    if (smax > 0) {
+        const double *y_ref = exch == EXCH_HALO ? x_loc : x + lo;
+        csr_t src = local_csr;
+        src.col_ind = mpk_cols;
+        double *t_rep = (double*) malloc(bench.reps * sizeof(double));
+        for (int s = 1; s <= smax; s++) {
+            mpk_t mpk;
+            double t0, t1;
+            MPI_Barrier(MPI_COMM_WORLD);
+            GET_TIME(t0);
+            mpk_setup(&mpk, &src, row_off, s, MPI_COMM_WORLD);
+            MPI_Barrier(MPI_COMM_WORLD);
+            GET_TIME(t1);
+            mpk_setup_time[ns] = t1 - t0;
+            for (int rep = -bench.warmup; rep < bench.reps; rep++) {
+                mpk_run(&mpk, x0_spmm, lo, iters, y_ref, MPI_COMM_WORLD, &mpk_res[ns]);
+                if (rep >= 0) t_rep[rep] = mpk_res[ns].time;
+                if (s == smax) bench_record(&bench, ph_mpk, rep, mpk_res[ns].time);
+            }
+            MPI_Allreduce(MPI_IN_PLACE, t_rep, bench.reps, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+            mpk_time[ns++] = bench_median(t_rep, bench.reps);
+            mpk_free(&mpk);
+        }
+        free(t_rep);
+    }
+    free(mpk_cols);
+
+    // Αποτέλεσμα CSR στον Master (εκτός χρονομέτρησης) για σύγκριση με το Dense
+    double *csr_result = NULL;
+    int *counts = NULL;
+    if (my_rank == 0) {
+        csr_result = malloc(n * sizeof(double));
+        counts = malloc(comm_sz * sizeof(int));
+        for (int r = 0; r < comm_sz; r++) counts[r] = row_off[r + 1] - row_off[r];
+    }
+    if (grid2d)
+        grid2d_gather(&grid, csr_result);
+    else
+        MPI_Gatherv(exch == EXCH_HALO ? x_loc : x + row_off[my_rank], local_n, MPI_DOUBLE,
+                    csr_result, counts, row_off, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    free(counts);
+    free(x0_perm); free(x0_spmm);
+
+    // RCM: επιστροφή του αποτελέσματος στην αρχική αρίθμηση, y[perm[k]] = y'[k]
+    if (reorder && my_rank == 0) {
+        double *unperm = malloc(n * sizeof(double));
+        for (int k = 0; k < n; k++) unperm[perm[k]] = csr_result[k];
+        free(csr_result);
+        csr_result = unperm;
     }
-    MPI_Barrier(MPI_COMM_WORLD);
-    GET_TIME(t_csr_calc_end);
 
     // Καθαρισμός CSR πινάκων πριν το Dense πείραμα
     free(local_csr.values); free(local_csr.col_ind); free(local_csr.row_ptr);
+    if (overlap) ovl_split_free(&split);
+    if (use_sell) free_sell(&sell);
+    if (compact) free_ccsr(&cc);
+    if (exch == EXCH_HALO) { halo_free(&halo); free(x_loc); }
 
     /* ======================================================
        PHASE 3: DENSE PARALLEL DISTRIBUTION & CALCULATION
        ====================================================== */
     
-    // Επαναφορά του x στην αρχική κατάσταση
-    memcpy(x, x_copy, n * sizeof(double));
+    // Πίνακας από αρχείο με πολύ μεγάλο τοπικό dense μπλοκ: μόνο CSR
+    ovl_dense.wait = 0.0;
+    if (run_dense) {
+        // Επαναφορά του x στην αρχική κατάσταση
+        if (shared) {
+            shm_vec_bcast(&xs, x_global);
+            x = shm_vec_x(&xs);
+        } else {
+            memcpy(x, x_copy, n * sizeof(double));
+        }
 
-    // Δέσμευση τοπικού πίνακα Dense (local_n * N στοιχεία)
-    double *local_A_dense = malloc(local_n * n * sizeof(double));
+        // Δέσμευση τοπικού πίνακα Dense (local_n * N στοιχεία)
+        // distgen: οι ίδιες γραμμές παράγονται τοπικά (εκτός χρονομέτρησης, όπως
+        // και η παραγωγή στον Master), οπότε δεν υπάρχει φάση διανομής.
+        // Αρχείο: οι γραμμές φτιάχτηκαν από το τοπικό CSR στη φάση 1.
+        // Παράλληλη μετατροπή: οι dense γραμμές διανεμήθηκαν ήδη στη φάση 2 (ίδιος χρόνος διανομής).
+        // 2D: το μπλοκ A_ij (nb x nb) από το CSR μπλοκ, ή από τον Master παρακάτω
+        if (grid2d && (distgen || infile)) local_A_dense = csr_to_dense_rows(&blk_csr, grid.nb);
+        else if (distgen) local_A_dense = gen_dense_rows(n, row_off[my_rank], row_off[my_rank + 1], sparsity, GEN_SEED);
+        else if (master_csr) local_A_dense = malloc((size_t) local_n * n * sizeof(double));
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    GET_TIME(t_dense_comm_start);
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_dense_comm_start);
 
-    // Διανομή Dense πίνακα (Χρήση απλού Scatter λόγω σταθερού μεγέθους)
-    MPI_Scatter(A_dense_global, local_n * n, MPI_DOUBLE,
-                local_A_dense, local_n * n, MPI_DOUBLE,
-                0, MPI_COMM_WORLD);
+        // Διανομή Dense πίνακα (Scatterv σε μονάδες γραμμών: datatype n doubles)
+        if (pconv && grid2d) {
+            local_A_dense = grid2d_scatter_dense(&grid, A_dense_global, n);
+        } else if (pconv) {
+            t_dense_comm_start = t_csr_comm_start;
+        } else if (master_csr) {
+            MPI_Datatype row_t;
+            MPI_Type_contiguous(n, MPI_DOUBLE, &row_t);
+            MPI_Type_commit(&row_t);
+            MPI_Scatterv(A_dense_global, row_cnt, row_off, row_t,
+                         local_A_dense, local_n, row_t,
+                         0, MPI_COMM_WORLD);
+            MPI_Type_free(&row_t);
+        }
 
-    MPI_Barrier(MPI_COMM_WORLD);
-    GET_TIME(t_dense_comm_end);
+        MPI_Barrier(MPI_COMM_WORLD);
+        GET_TIME(t_dense_comm_end);
+        if (pconv && !grid2d) t_dense_comm_end = t_csr_comm_end;
 
-    // Dense Loop
-    MPI_Barrier(MPI_COMM_WORLD);
-    GET_TIME(t_dense_calc_start);
-
-    for (int iter = 0; iter < iters; iter++) {
-        // Υπολογισμός Dense (Πράξεις και με τα μηδενικά)
-        for (int i = 0; i < local_n; i++) {
-            double sum = 0.0;
-            for (int j = 0; j < n; j++) {
-                sum += local_A_dense[i*n + j] * x[j];
+        if (overlap) t_exch_dense = ovl_calibrate(EXCH_ALLGATHER, NULL, x, n, row_off);
+
+        // Dense Loop
+        for (int rep = -bench.warmup; rep < bench.reps; rep++) {
+            if (rep > -bench.warmup) {
+                if (shared) { shm_vec_bcast(&xs, x_global); x = shm_vec_x(&xs); }
+                else memcpy(x, x_copy, n * sizeof(double));
+            }
+            double t_work = 0.0, t_k0, t_k1;
+            if (rep == 0) perf_reset(&pf, pf_dense);
+
+            MPI_Barrier(MPI_COMM_WORLD);
+            GET_TIME(t_dense_calc_start);
+
+            if (overlap) ovl_dense_loop(local_A_dense, n, x, row_off, iters, local_y, &ovl_dense);
+            if (grid2d) t_work = grid2d_dense_loop(&grid, local_A_dense, x, iters);
+
+            for (int iter = 0; iter < iters && !overlap && !grid2d; iter++) {
+                // Υπολογισμός Dense (Πράξεις και με τα μηδενικά)
+                perf_start(&pf, pf_dense);
+                GET_TIME(t_k0);
+                #pragma omp parallel for schedule(static)
+                for (int i = 0; i < local_n; i++) {
+                    double sum = 0.0;
+                    for (int j = 0; j < n; j++) {
+                        sum += local_A_dense[(size_t) i*n + j] * x[j];
+                    }
+                    local_y[i] = sum;
+                }
+                GET_TIME(t_k1);
+                perf_stop(&pf, pf_dense, t_k1 - t_k0, dense_flops, dense_bytes);
+                t_work += t_k1 - t_k0;
+                // Συγχρονισμός αποτελεσμάτων
+                if (shared) {
+                    shm_vec_exchange(&xs, local_y);
+                    x = shm_vec_x(&xs);
+                } else {
+                    MPI_Allgatherv(local_y, local_n, MPI_DOUBLE, x, row_cnt, row_off, MPI_DOUBLE, MPI_COMM_WORLD);
+                }
             }
-            local_y[i] = sum;
+            GET_TIME(t_k0);
+            MPI_Barrier(MPI_COMM_WORLD);
+            GET_TIME(t_dense_calc_end);
+            if (overlap) t_work = t_k0 - t_dense_calc_start - ovl_dense.wait;
+            bench_record(&bench, ph_dense_calc, rep, t_dense_calc_end - t_dense_calc_start);
+            bench_record(&bench, ph_dense_work, rep, t_work);
         }
-        // Συγχρονισμός αποτελεσμάτων
-        MPI_Allgather(local_y, local_n, MPI_DOUBLE, x, local_n, MPI_DOUBLE, MPI_COMM_WORLD);
+        if (grid2d) grid2d_gather(&grid, x);   // Τελικό x στον Master (για τον έλεγχο)
     }
-
-    MPI_Barrier(MPI_COMM_WORLD);
-    GET_TIME(t_dense_calc_end);
+    if (grid2d) { free_csr(&blk_csr); grid2d_free(&grid); }
 
     /* ======================================================
        PHASE 4: RESULTS & CLEANUP
        ====================================================== */
+
+    // Overlap: χρόνος μπλοκαρίσματος της πιο αργής διεργασίας και πλήθος interior γραμμών
+    double wait_csr = 0.0, wait_dense = 0.0;
+    int n_int = 0;
+    if (overlap) {
+        MPI_Reduce(&ovl_csr.wait, &wait_csr, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&ovl_dense.wait, &wait_dense, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&split.n_int, &n_int, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    }
     
+    // Harness: στατιστικά των επαναλήψεων. Οι χρόνοι βρόχων της αναφοράς είναι
+    // median (ως προς τις επαναλήψεις) της πιο αργής διεργασίας.
+    bench_param(&bench, "n", "%d", n);
+    bench_param(&bench, "sparsity", "%.4f", sparsity);
+    bench_param(&bench, "iters", "%d", iters);
+    bench_param(&bench, "T", "%d", nthreads);
+    bench_param(&bench, "exch", "%s", exch == EXCH_HALO ? "halo" : "allgather");
+    bench_param(&bench, "fmt", "%s", fmt_name(use_sell ? FMT_SELL : FMT_CSR));
+    bench_param(&bench, "overlap", "%d", overlap);
+    bench_param(&bench, "shared", "%d", shared);
+    bench_param(&bench, "rcm", "%d", reorder);
+    bench_param(&bench, "solver", "%s", solver_name(solver));
+    bench_param(&bench, "k", "%d", kmax);
+    bench_param(&bench, "s", "%d", smax);
+    bench_param(&bench, "grid2d", "%d", grid2d);
+    bench_param(&bench, "balance", "%d", balance);
+    bench_param(&bench, "compact", "%s", compact ? cval_name(cc.vmode) : "none");
+    bench_finish(&bench, MPI_COMM_WORLD);
+    double csr_calc = bench.stat[ph_csr_calc].med;
+    double dense_calc = bench.stat[ph_dense_calc].med;
+
     // Συλλογή τελικού αποτελέσματος (μόνο για επιβεβαίωση στον Master)
     double *final_result = NULL;
     if (my_rank == 0) final_result = malloc(n * sizeof(double));
-    if (my_rank == 0) memcpy(final_result, x, n * sizeof(double));
+    if (my_rank == 0) memcpy(final_result, run_dense ? x : csr_result, n * sizeof(double));
 
     if (my_rank == 0) {
         // Υπολογισμός συνολικών χρόνων
         double csr_total = (t_csr_create_end - t_csr_create_start) + 
                            (t_csr_comm_end - t_csr_comm_start) +     
-                           (t_csr_calc_end - t_csr_calc_start);      
+                           (t_part_end - t_part_start) +
+                           (t_grid_end - t_grid_start) +
+                           (t_rcm_end - t_rcm_start) +
+                           (t_halo_end - t_halo_start) +
+                           (t_sell_end - t_sell_start) +
+                           (t_cc_enc_end - t_cc_enc_start) + (t_cc_end - t_cc_start) +
+                           csr_calc;
+
+        // Έλεγχος: CSR και Dense υπολογίζουν το ίδιο A^iters * x.
+        // Σχετικό ως προς τη νόρμα max: με RCM η σειρά των αθροισμάτων αλλάζει
+        // και στοιχεία με απαλοιφές (π.χ. Laplacian) έχουν μεγάλο σχετικό
+        // σφάλμα ανά στοιχείο, ενώ το διάνυσμα είναι σωστό.
+        double max_rel = 0.0, ref = 1.0;
+        for (int k = 0; k < n; k++) if (fabs(final_result[k]) > ref) ref = fabs(final_result[k]);
+        for (int k = 0; k < n; k++) {
+            double d = fabs(csr_result[k] - final_result[k]) / ref;
+            if (d > max_rel) max_rel = d;
+        }
         
         double dense_total = (t_dense_comm_end - t_dense_comm_start) + 
-                             (t_dense_calc_end - t_dense_calc_start);
+                             dense_calc;
 
         // Εκτύπωση αποτελεσμάτων σύμφωνα με την εκφώνηση
         printf("\n=== RESULTS (N=%d, Sparsity=%.2f, P=%d, Iters=%d) ===\n", n, sparsity, comm_sz, iters);
-        printf("(i)   CSR Creation Time:      %e sec\n", t_csr_create_end - t_csr_create_start);
-        printf("(ii)  CSR Comm Time (Distr):  %e sec\n", t_csr_comm_end - t_csr_comm_start);
-        printf("(iii) CSR Calc Time:          %e sec\n", t_csr_calc_end - t_csr_calc_start);
+        if (nthreads > 1) printf("Threads per rank T:           %d\n", nthreads);
+        if (shared) {
+            // Μνήμη για το x στον κόμβο του Master: 2 κοινά διανύσματα έναντι x + x_copy ανά διεργασία
+            printf("Shared x (per node):          %d node(s), %.2f MB/node (private: %.2f MB/node)\n",
+                   xs.nnodes, 2.0 * n * sizeof(double) / 1e6,
+                   2.0 * xs.node_size * n * sizeof(double) / 1e6);
+        }
+        if (infile)
+            printf("Matrix file:                  %s (%lld entries in file)\n", infile, file_nnz);
+        printf("(i)   CSR Creation Time:      %e sec%s\n", t_csr_create_end - t_csr_create_start,
+               distgen ? " (distributed generation, max over ranks)" :
+               infile ? " (file load, max over ranks)" :
+               pconv ? " (parallel conversion of dense row blocks, max over ranks)" : "");
+        printf("(ii)  CSR Comm Time (Distr):  %e sec%s\n", t_csr_comm_end - t_csr_comm_start,
+               pconv ? " (dense row blocks)" : "");
+        if (balance)
+            printf("      nnz Partition Time:     %e sec\n", t_part_end - t_part_start);
+        if (grid2d)
+            printf("      2D Block Redistr. Time: %e sec\n", t_grid_end - t_grid_start);
+        if (reorder)
+            printf("      RCM Reorder Time:       %e sec\n", t_rcm_end - t_rcm_start);
+        if (exch == EXCH_HALO)
+            printf("      Halo Setup Time:        %e sec\n", t_halo_end - t_halo_start);
+        if (use_sell)
+            printf("      SELL Conversion Time:   %e sec\n", t_sell_end - t_sell_start);
+        if (compact)
+            printf("      Compact Encode Time:    %e sec (Master %e, local %e)\n",
+                   t_cc_enc_end - t_cc_enc_start + t_cc_end - t_cc_start,
+                   t_cc_enc_end - t_cc_enc_start, t_cc_end - t_cc_start);
+        printf("(iii) CSR Calc Time:          %e sec\n", csr_calc);
         printf("(iv)  Total CSR Time:         %e sec\n", csr_total);
         printf("(v)   Total Dense Time (MPI): %e sec\n", dense_total);
         printf("----------------------------------------------------\n");
-        printf("Dense Comm Time:              %e sec\n", t_dense_comm_end - t_dense_comm_start);
-        printf("Dense Calc Time:              %e sec\n", t_dense_calc_end - t_dense_calc_start);
+        printf("Dense Comm Time:              %e sec%s\n", t_dense_comm_end - t_dense_comm_start,
+               pconv && !grid2d ? " (same scatter as the CSR distribution)" : "");
+        printf("Dense Calc Time:              %e sec\n", dense_calc);
+        printf("Calc imbalance (max/mean):    CSR %.3f, Dense %.3f\n",
+               bench.stat[ph_csr_work].imbalance, bench.stat[ph_dense_work].imbalance);
+        if (balance)
+            printf("Row partition:                nnz-balanced, nnz imbalance (max/mean) %.3f -> %.3f\n",
+                   imb_uniform, imb_balanced);
+        else
+            printf("Row partition:                uniform, nnz imbalance (max/mean) %.3f\n", imb_uniform);
+        printf("CSR Comm Volume / iter:       %.4f MB total, %.4f MB max/rank, %d max neighbors (%s)\n",
+               vol_total / 1e6, vol_max / 1e6, nbr_max,
+               exch == EXCH_HALO ? "halo" : grid2d ? "2d grid" : "allgather");
+        if (exch == EXCH_HALO || grid2d)
+            printf("                              (allgather would move %.4f MB total)\n",
+                   (double) (comm_sz - 1) * n * sizeof(double) / 1e6);
+        if (grid2d)
+            printf("Process grid:                 %d x %d, %d x %d blocks (y_i reduced across rows, x_j bcast down columns)\n",
+                   grid.q, grid.q, grid.nb, grid.nb);
+        if (fmt != FMT_CSR) {
+            printf("Sparse format:                %s%s (nnz/row %.1f, cv %.2f, density %.4f, SELL fill %.2f)\n",
+                   fmt_name(chosen), fmt == FMT_AUTO ? " [auto]" : "", fst.mean, fst.cv, fst.density, fst.fill);
+            if (use_sell)
+                printf("                              SELL-C-sigma C=%d sigma=%d, %s kernel\n",
+                       SELL_C, SELL_SIGMA, sell_isa_name());
+            if (chosen == FMT_DENSE)
+                printf("                              dense path selected (CSR phase kept for comparison)\n");
+            else if (chosen == FMT_SELL && !use_sell)
+                printf("                              (overlap uses CSR row lists: SELL not applied)\n");
+        }
+        if (compact) {
+            printf("Compact CSR:                  %s values%s, %d-row chunks\n", cval_name(cc.vmode),
+                   cc.vmode == CVAL_FLOAT ? (cc_exact ? " (exact)" : " (LOSSY)") : "", CCSR_CHUNK);
+            printf("Compact bytes / nnz:          %.2f (CSR %.2f, %.2fx smaller)\n",
+                   cc_bytes[0] / cc_bytes[2], cc_bytes[1] / cc_bytes[2], cc_bytes[1] / cc_bytes[0]);
+            printf("Compact SpMV time:            %e sec (CSR %e sec, %.2fx, kernel only)\n",
+                   cc_t_ccsr, cc_t_csr, cc_t_ccsr > 0.0 ? cc_t_csr / cc_t_ccsr : 0.0);
+            if (!distgen && !infile)
+                printf("Compact scatter payload:      %.4f MB (CSR %.4f MB)\n", cc_scatter_bytes / 1e6,
+                       ((double) global_csr.nnz * (sizeof(double) + sizeof(int)) + n * sizeof(int)) / 1e6);
+        }
+        if (reorder) {
+            printf("RCM bandwidth / profile:      %lld / %lld -> %lld / %lld\n",
+                   rcm_before.bandwidth, rcm_before.profile, rcm_after.bandwidth, rcm_after.profile);
+            printf("RCM SpMV time / iter:         %e -> %e sec (%+.1f%%, probe with %s",
+                   probe_before, probe_after, 100.0 * (probe_after - probe_before) / probe_before,
+                   exch == EXCH_HALO ? "halo" : "allgather");
+            if (exch == EXCH_HALO) printf(", ghosts %lld -> %lld", ghosts_before, ghosts_after);
+            printf(")\n");
+            if (probe_after < probe_before)
+                printf("RCM pays off after:           %.0f iterations\n",
+                       ceil((t_rcm_end - t_rcm_start) / (probe_before - probe_after)));
+            else
+                printf("RCM pays off after:           never (no SpMV speedup)\n");
+        }
+        if (solver != SOLVER_NONE) {
+            double t_solve = bench.stat[ph_solve].med;
+            printf("Solver:                       %s (tol %.1e, max %d iters)\n", solver_name(solver), tol, maxit);
+            printf("Solver iterations:            %d, %s (relative residual %.3e)\n", kres.iters,
+                   kres.breakdown ? "BREAKDOWN (curvature <= 0 or non-finite alpha: A not SPD?)" :
+                   kres.converged ? "converged" : "NOT converged", kres.resid);
+            printf("Solver time:                  %e sec, %e sec/iter\n", t_solve,
+                   kres.iters > 0 ? t_solve / kres.iters : 0.0);
+            printf("Global reductions / iter:     %d Allreduce%s + SpMV exchange (%s)\n", kres.reductions,
+                   solver == SOLVER_PIPECG ? " (non-blocking, overlapped with the SpMV)" : "",
+                   exch == EXCH_HALO ? "halo, neighbors only" : "allgather, global");
+            if (solver == SOLVER_POWER)
+                printf("Dominant eigenvalue:          %.10g\n", kres.lambda);
+            else
+                printf("Error vs exact solution:      %.3e (max |x - 1|, b = A*1)\n", kres.err);
+        }
+        if (kmax > 0) {
+            // GFLOP/s: 2 πράξεις ανά μη-μηδενικό και διάνυσμα, με την ανταλλαγή στον χρόνο
+            printf("SpMM (CSR, %s lanes, %s, 1 exchange of all k vectors / iter):\n",
+                   spmm_isa_name(), exch == EXCH_HALO ? "halo" : "allgather");
+            printf("%10s %14s %14s %10s %14s %10s\n", "k", "time/iter", "time/iter/vec", "GFLOP/s",
+                   "speedup/vec", "check");
+            for (int s = 0; s < nk; s++) {
+                double per_iter = iters > 0 ? spmm_time[s] / iters : 0.0;
+                double gf = spmm_time[s] > 0.0 ? 2.0 * nnz_total * spmm_res[s].k * iters / spmm_time[s] / 1e9 : 0.0;
+                double speedup = spmm_time[s] > 0.0 ? spmm_time[0] * spmm_res[s].k / spmm_time[s] : 0.0;
+                printf("%10d %14e %14e %10.3f %13.2fx %10s\n", spmm_res[s].k, per_iter,
+                       per_iter / spmm_res[s].k, gf, speedup, spmm_res[s].err <= 1e-12 ? "PASSED" : "FAILED");
+            }
+        }
+        if (smax > 0) {
+            // Μηνύματα: άθροισμα γειτόνων ανά ανταλλαγή (s = 1 είναι το halo ανά επανάληψη).
+            // Extra flops: πλεονάζουσες πράξεις των ghost γραμμών ως προς iters SpMV.
+            printf("Matrix powers (CSR, 1 neighbor exchange of the depth-s ghosts per s iters):\n");
+            printf("%6s %10s %10s %11s %12s %12s %13s %13s %9s %8s\n", "s", "exchanges", "messages",
+                   "msgs saved", "ghosts/exch", "extra flops", "setup", "time/iter", "speedup", "check");
+            for (int k = 0; k < ns; k++) {
+                double saved = mpk_res[0].msgs > 0 ? 1.0 - (double) mpk_res[k].msgs / mpk_res[0].msgs : 0.0;
+                printf("%6d %10d %10lld %10.1f%% %12lld %11.1f%% %13e %13e %8.2fx %8s\n",
+                       mpk_res[k].s, mpk_res[k].nexch, mpk_res[k].msgs, 100.0 * saved, mpk_res[k].ghosts,
+                       100.0 * mpk_res[k].extra, mpk_setup_time[k], iters > 0 ? mpk_time[k] / iters : 0.0,
+                       mpk_time[k] > 0.0 ? mpk_time[0] / mpk_time[k] : 0.0,
+                       mpk_res[k].err <= 1e-12 ? "PASSED" : "FAILED");
+            }
+            printf("                              (allgather loop: %d exchanges, %lld messages)\n",
+                   iters, (long long) iters * comm_sz * (comm_sz - 1));
+        }
+        if (run_dense)
+            printf("Check (CSR vs Dense):         %s (max rel diff %.1e)\n",
+                   max_rel <= 1e-12 ? "PASSED" : "FAILED", max_rel);
+        else
+            printf("Check (CSR vs Dense):         SKIPPED (local dense block > %.1f GB)\n",
+                   DENSE_MAX_BYTES / 1e9);
+        if (overlap) {
+            printf("Interior rows (CSR):          %d of %d (%.1f%%)\n", n_int, n, 100.0 * n_int / n);
+            print_overlap("CSR", t_exch_csr, wait_csr, iters);
+            print_overlap("Dense", t_exch_dense, wait_dense, iters);
+        }
+
+        if (bench.reps > 1 || results) bench_print(&bench);
+        if (results && bench_write(&bench, results) != 0)
+            printf("Warning: cannot write %s (not writable, or a CSV with other columns)\n", results);
 
         if (n <= 10) {
             printf("Final Result Vector: ");
@@ -282,12 +1086,21 @@ int main(int argc, char* argv[]) {
         }
         
         // Αποδέσμευση μνήμης Master
-        free(A_dense_global); free(x_global); free(final_result); free_csr(&global_csr);
-        free(scounts); free(displs);
+        free(A_dense_global); free(x_global); free(final_result); free(csr_result);
+        if (master_csr) free_csr(&global_csr);
+        if (!distgen && !infile && compact) free_ccsr(&global_cc);
     }
 
+    // Roofline των πυρήνων (-H): STREAM triad σε όλες τις διεργασίες, μετά η αναφορά
+    perf_stream(&pf, MPI_COMM_WORLD);
+    perf_report(&pf, MPI_COMM_WORLD);
+    perf_free(&pf);
+
     // Αποδέσμευση τοπικής μνήμης
-    free(x); free(x_copy); free(local_y); free(local_A_dense);
+    if (shared) shm_vec_free(&xs);
+    else { free(x); free(x_copy); }
+    free(row_off); free(row_cnt); free(local_y); free(local_A_dense); free(perm);
+    bench_free(&bench);
     MPI_Finalize();
     return 0;
 }
\ No newline at end of file
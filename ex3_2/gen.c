@@ -0,0 +1,76 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include "spmv.h"
+
+/* ======================================================
+   Κατανεμημένη παραγωγή του συνθετικού πίνακα
+   ======================================================
+   Το rand() είναι ακολουθιακό: για να πάρουμε το στοιχείο (i, j) πρέπει να
+   έχουν παραχθεί όλα τα προηγούμενα, άρα μόνο ο Master μπορεί να φτιάξει
+   τον πίνακα. Εδώ κάθε στοιχείο είναι συνάρτηση ΜΟΝΟ του (seed, i*n + j)
+   (counter-based RNG: ο finalizer του SplitMix64 πάνω στον μετρητή), οπότε
+   κάθε διεργασία παράγει απευθείας τις γραμμές της και ο πίνακας είναι
+   ίδιος για οποιοδήποτε P. Οι δείκτες είναι 64-bit (n*n > 2^31). */
+
+static inline uint64_t mix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Στοιχείο (i, j): 0 με πιθανότητα sparsity, αλλιώς ακέραιος 1..10 (όπως το αρχικό)
+double gen_entry(uint64_t seed, int n, int i, int j, double sparsity) {
+    uint64_t ctr = 2 * ((uint64_t) i * (uint64_t) n + (uint64_t) j);
+    double r = (mix64(seed ^ ctr) >> 11) * 0x1.0p-53;   // Ομοιόμορφο στο [0, 1)
+    if (r <= sparsity) return 0.0;
+    return (double) (mix64(seed ^ (ctr + 1)) % 10 + 1);
+}
+
+// Γραμμές [row_lo, row_hi) σε CSR (τοπικό row_ptr, 0-based), χωρίς dense ενδιάμεσο
+csr_t gen_csr_rows(int n, int row_lo, int row_hi, double sparsity, uint64_t seed) {
+    csr_t mat;
+    int rows = row_hi - row_lo;
+    mat.n = rows;
+    mat.row_ptr = (int*) malloc((rows + 1) * sizeof(int));
+
+    // Pass 1: μη-μηδενικά ανά γραμμή (ανεξάρτητες γραμμές -> νήματα)
+    mat.row_ptr[0] = 0;
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < rows; i++) {
+        int cnt = 0;
+        for (int j = 0; j < n; j++) cnt += gen_entry(seed, n, row_lo + i, j, sparsity) != 0.0;
+        mat.row_ptr[i + 1] = cnt;
+    }
+    for (int i = 0; i < rows; i++) mat.row_ptr[i + 1] += mat.row_ptr[i];
+    mat.nnz = mat.row_ptr[rows];
+
+    mat.values = (double*) malloc(mat.nnz * sizeof(double));
+    mat.col_ind = (int*) malloc(mat.nnz * sizeof(int));
+
+    // Pass 2: γέμισμα (κάθε γραμμή γράφει στο δικό της τμήμα)
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < rows; i++) {
+        int k = mat.row_ptr[i];
+        for (int j = 0; j < n; j++) {
+            double val = gen_entry(seed, n, row_lo + i, j, sparsity);
+            if (val != 0.0) {
+                mat.values[k] = val;
+                mat.col_ind[k] = j;
+                k++;
+            }
+        }
+    }
+    return mat;
+}
+
+// Γραμμές [row_lo, row_hi) σε dense μορφή (rows x n)
+double *gen_dense_rows(int n, int row_lo, int row_hi, double sparsity, uint64_t seed) {
+    int rows = row_hi - row_lo;
+    double *A = (double*) malloc((size_t) rows * n * sizeof(double));
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < rows; i++)
+        for (int j = 0; j < n; j++)
+            A[(size_t) i * n + j] = gen_entry(seed, n, row_lo + i, j, sparsity);
+    return A;
+}
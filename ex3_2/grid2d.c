@@ -0,0 +1,157 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include "spmv.h"
+#include "timer.h"
+
+/* ======================================================
+   2D διάσπαση σε πλέγμα q x q διεργασιών (P = q^2)
+   ======================================================
+   Με μπλοκ γραμμών κάθε διεργασία χρειάζεται ΟΛΟ το x (Allgather n - n/P
+   στοιχείων ανά επανάληψη), όσο κι αν μεγαλώσει το P. Εδώ η διεργασία
+   (i, j) κατέχει το μπλοκ A_ij (γραμμές i*nb.., στήλες j*nb.., nb = n/q)
+   και χρειάζεται μόνο το x_j:
+     1. y_ij = A_ij x_j                                  (τοπικά)
+     2. y_i = Σ_j y_ij: MPI_Reduce στη γραμμή i, ρίζα η διαγώνια (i, i)
+     3. x_i = y_i: MPI_Bcast στη στήλη i από τη διαγώνια (i, i)
+   Κάθε διεργασία στέλνει / λαμβάνει O(nb) = O(n / sqrt(P)) στοιχεία. Ο
+   communicator είναι καρτεσιανός χωρίς αναδιάταξη (cart rank = world rank,
+   (i, j) = (rank / q, rank % q)), με υπο-communicators γραμμής και στήλης. */
+
+int grid2d_create(grid2d_t *g, int n, MPI_Comm comm) {
+    int comm_sz, my_rank;
+    MPI_Comm_size(comm, &comm_sz);
+    MPI_Comm_rank(comm, &my_rank);
+    int q = (int) lround(sqrt((double) comm_sz));
+    if (q * q != comm_sz || n % q != 0) return -1;
+
+    int dims[2] = { q, q }, periods[2] = { 0, 0 }, coords[2];
+    MPI_Cart_create(comm, 2, dims, periods, 0, &g->cart);
+    MPI_Cart_coords(g->cart, my_rank, 2, coords);
+    int keep_row[2] = { 0, 1 }, keep_col[2] = { 1, 0 };
+    MPI_Cart_sub(g->cart, keep_row, &g->row);   // Ίδια γραμμή πλέγματος, rank = j
+    MPI_Cart_sub(g->cart, keep_col, &g->col);   // Ίδια στήλη πλέγματος, rank = i
+
+    g->q = q;
+    g->pr = coords[0];
+    g->pc = coords[1];
+    g->nb = n / q;
+    g->row_lo = g->pr * g->nb;
+    g->col_lo = g->pc * g->nb;
+    g->xj = (double*) malloc((g->nb + 1) * sizeof(double));
+    g->ypart = (double*) malloc((g->nb + 1) * sizeof(double));
+    g->yi = (double*) malloc((g->nb + 1) * sizeof(double));
+    return 0;
+}
+
+void grid2d_free(grid2d_t *g) {
+    MPI_Comm_free(&g->row); MPI_Comm_free(&g->col); MPI_Comm_free(&g->cart);
+    free(g->xj); free(g->ypart); free(g->yi);
+}
+
+// Κάθε στοιχείο πηγαίνει στον ιδιοκτήτη του μπλοκ του. Με "εικονική" γραμμή
+// dest * nb + (row - row_lo του μπλοκ) το csr_from_triplets (Alltoallv κατά
+// row_off = r * nb) φτιάχνει απευθείας το τοπικό CSR του μπλοκ.
+csr_t grid2d_csr(const grid2d_t *g, const csr_t *local, int lo) {
+    int comm_sz = g->q * g->q, nb = g->nb;
+    csr_ij_t *ij = (csr_ij_t*) malloc((local->nnz + 1) * sizeof(csr_ij_t));
+    for (int i = 0; i < local->n; i++) {
+        int row = lo + i;
+        for (int k = local->row_ptr[i]; k < local->row_ptr[i + 1]; k++) {
+            int col = local->col_ind[k];
+            int dest = (row / nb) * g->q + col / nb;
+            ij[k].row = dest * nb + row % nb;
+            ij[k].col = col % nb;
+        }
+    }
+    int *blk_off = (int*) malloc((comm_sz + 1) * sizeof(int));
+    for (int r = 0; r <= comm_sz; r++) blk_off[r] = r * nb;
+    csr_t B = csr_from_triplets(ij, local->values, local->nnz, blk_off, g->cart);
+    free(ij); free(blk_off);
+    return B;
+}
+
+// Ο Master στέλνει σε κάθε (i, j) το μπλοκ nb x nb του A_global (datatype με
+// βήμα n, χωρίς αντιγραφή). Επιστρέφει το τοπικό μπλοκ (row-major, nb x nb).
+double *grid2d_scatter_dense(const grid2d_t *g, const double *A_global, int n) {
+    int nb = g->nb, my_rank;
+    MPI_Comm_rank(g->cart, &my_rank);
+    double *D = (double*) malloc((size_t) nb * nb * sizeof(double));
+
+    if (my_rank == 0) {
+        MPI_Datatype blk;
+        MPI_Type_vector(nb, nb, n, MPI_DOUBLE, &blk);
+        MPI_Type_commit(&blk);
+        MPI_Request *req = (MPI_Request*) malloc(g->q * g->q * sizeof(MPI_Request));
+        for (int r = 1; r < g->q * g->q; r++) {
+            const double *src = A_global + (size_t) (r / g->q) * nb * n + (size_t) (r % g->q) * nb;
+            MPI_Isend(src, 1, blk, r, 0, g->cart, &req[r]);
+        }
+        for (int i = 0; i < nb; i++) memcpy(D + (size_t) i * nb, A_global + (size_t) i * n, nb * sizeof(double));
+        MPI_Waitall(g->q * g->q - 1, req + 1, MPI_STATUSES_IGNORE);
+        MPI_Type_free(&blk);
+        free(req);
+    } else {
+        MPI_Recv(D, nb * nb, MPI_DOUBLE, 0, 0, g->cart, MPI_STATUS_IGNORE);
+    }
+    return D;
+}
+
+// Βήματα 2-3: μερικά y -> διαγώνιος -> x_j σε όλη τη στήλη
+static void grid2d_update(grid2d_t *g) {
+    MPI_Reduce(g->ypart, g->yi, g->nb, MPI_DOUBLE, MPI_SUM, g->pr, g->row);
+    if (g->pr == g->pc) memcpy(g->xj, g->yi, g->nb * sizeof(double));
+    MPI_Bcast(g->xj, g->nb, MPI_DOUBLE, g->pc, g->col);
+}
+
+double grid2d_csr_loop(grid2d_t *g, const csr_t *B, const double *x0, int iters) {
+    double t_work = 0.0, t0, t1;
+    memcpy(g->xj, x0 + g->col_lo, g->nb * sizeof(double));
+    for (int iter = 0; iter < iters; iter++) {
+        GET_TIME(t0);
+        #pragma omp parallel for schedule(guided)
+        for (int i = 0; i < B->n; i++) {
+            double sum = 0.0;
+            for (int k = B->row_ptr[i]; k < B->row_ptr[i + 1]; k++) sum += B->values[k] * g->xj[B->col_ind[k]];
+            g->ypart[i] = sum;
+        }
+        GET_TIME(t1);
+        t_work += t1 - t0;
+        grid2d_update(g);
+    }
+    return t_work;
+}
+
+double grid2d_dense_loop(grid2d_t *g, const double *D, const double *x0, int iters) {
+    double t_work = 0.0, t0, t1;
+    int nb = g->nb;
+    memcpy(g->xj, x0 + g->col_lo, nb * sizeof(double));
+    for (int iter = 0; iter < iters; iter++) {
+        GET_TIME(t0);
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < nb; i++) {
+            double sum = 0.0;
+            for (int j = 0; j < nb; j++) sum += D[(size_t) i * nb + j] * g->xj[j];
+            g->ypart[i] = sum;
+        }
+        GET_TIME(t1);
+        t_work += t1 - t0;
+        grid2d_update(g);
+    }
+    return t_work;
+}
+
+// Οι διαγώνιες διεργασίες έχουν τα x_i: συλλογή στον Master (x_root: n στοιχεία)
+void grid2d_gather(const grid2d_t *g, double *x_root) {
+    int comm_sz = g->q * g->q, my_rank;
+    MPI_Comm_rank(g->cart, &my_rank);
+    int *counts = NULL, *displs = NULL;
+    if (my_rank == 0) {
+        counts = (int*) calloc(comm_sz, sizeof(int));
+        displs = (int*) calloc(comm_sz, sizeof(int));
+        for (int i = 0; i < g->q; i++) { counts[i * g->q + i] = g->nb; displs[i * g->q + i] = i * g->nb; }
+    }
+    MPI_Gatherv(g->xj, g->pr == g->pc ? g->nb : 0, MPI_DOUBLE, x_root, counts, displs, MPI_DOUBLE, 0, g->cart);
+    free(counts); free(displs);
+}
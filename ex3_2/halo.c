@@ -0,0 +1,160 @@
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "spmv.h"
+
+/* ======================================================
+   Halo exchange για το CSR SpMV
+   ======================================================
+   Με το Allgather κάθε διεργασία λαμβάνει ΟΛΟ το x σε κάθε επανάληψη, ενώ
+   διαβάζει μόνο τις στήλες που εμφανίζονται στο col_ind της. Στο setup:
+   1. Βρίσκουμε τις ξένες στήλες (ghosts) που χρειαζόμαστε, ταξινομημένες,
+      άρα ομαδοποιημένες ανά ιδιοκτήτη (οι γραμμές είναι συνεχή μπλοκ).
+   2. Ενημερώνουμε κάθε ιδιοκτήτη τι να μας στέλνει (Alltoall/Alltoallv).
+   3. Επαναρίθμηση του col_ind: δική μας στήλη c -> c - lo, ghost -> local_n + k.
+   4. Γράφος γειτόνων (MPI_Dist_graph_create_adjacent) για το
+      MPI_Neighbor_alltoallv κάθε επανάληψης.
+   Το τοπικό x έχει μήκος local_n + nghost: [δικά μας | ghosts]. */
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+// Ιδιοκτήτης της γραμμής/στήλης c: το r με row_off[r] <= c < row_off[r+1]
+static int owner_of(int c, const int *row_off, int comm_sz) {
+    int lo = 0, hi = comm_sz - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (row_off[mid] <= c) lo = mid; else hi = mid - 1;
+    }
+    return lo;
+}
+
+void halo_setup(halo_t *h, csr_t *A, const int *row_off, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    int lo = row_off[my_rank], hi = row_off[my_rank + 1];
+    h->local_n = hi - lo;
+
+    // 1. Μοναδικές ξένες στήλες (ταξινόμηση + αφαίρεση διπλών)
+    int *cols = (int*) malloc((A->nnz + 1) * sizeof(int));
+    int m = 0;
+    for (int k = 0; k < A->nnz; k++) {
+        int c = A->col_ind[k];
+        if (c < lo || c >= hi) cols[m++] = c;
+    }
+    qsort(cols, m, sizeof(int), cmp_int);
+    int ng = 0;
+    for (int k = 0; k < m; k++) if (ng == 0 || cols[k] != cols[ng - 1]) cols[ng++] = cols[k];
+    h->nghost = ng;
+    h->ghost_cols = (int*) realloc(cols, (ng + 1) * sizeof(int));
+
+    // Πόσα ghosts από κάθε διεργασία
+    int *need = (int*) calloc(comm_sz, sizeof(int));
+    for (int k = 0; k < ng; k++) need[owner_of(h->ghost_cols[k], row_off, comm_sz)]++;
+
+    // 2. Κάθε ιδιοκτήτης μαθαίνει πόσα και ποια στοιχεία να στέλνει
+    int *give = (int*) malloc(comm_sz * sizeof(int));
+    MPI_Alltoall(need, 1, MPI_INT, give, 1, MPI_INT, comm);
+
+    int *need_displs = (int*) malloc(comm_sz * sizeof(int));
+    int *give_displs = (int*) malloc(comm_sz * sizeof(int));
+    int total_give = 0;
+    for (int r = 0; r < comm_sz; r++) {
+        need_displs[r] = r > 0 ? need_displs[r - 1] + need[r - 1] : 0;
+        give_displs[r] = total_give;
+        total_give += give[r];
+    }
+    h->send_idx = (int*) malloc((total_give + 1) * sizeof(int));
+    MPI_Alltoallv(h->ghost_cols, need, need_displs, MPI_INT,
+                  h->send_idx, give, give_displs, MPI_INT, comm);
+    for (int k = 0; k < total_give; k++) h->send_idx[k] -= lo;   // Global -> τοπικός δείκτης
+
+    // Συμπαγείς λίστες γειτόνων (μόνο όσοι έχουν count > 0)
+    h->nrecv = h->nsend = 0;
+    for (int r = 0; r < comm_sz; r++) { h->nrecv += need[r] > 0; h->nsend += give[r] > 0; }
+    h->recv_ranks = (int*) malloc((h->nrecv + 1) * sizeof(int));
+    h->recv_counts = (int*) malloc((h->nrecv + 1) * sizeof(int));
+    h->recv_displs = (int*) malloc((h->nrecv + 1) * sizeof(int));
+    h->send_ranks = (int*) malloc((h->nsend + 1) * sizeof(int));
+    h->send_counts = (int*) malloc((h->nsend + 1) * sizeof(int));
+    h->send_displs = (int*) malloc((h->nsend + 1) * sizeof(int));
+    for (int r = 0, a = 0, b = 0; r < comm_sz; r++) {
+        if (need[r] > 0) {
+            h->recv_ranks[a] = r; h->recv_counts[a] = need[r]; h->recv_displs[a] = need_displs[r]; a++;
+        }
+        if (give[r] > 0) {
+            h->send_ranks[b] = r; h->send_counts[b] = give[r]; h->send_displs[b] = give_displs[r]; b++;
+        }
+    }
+    h->nsend_vals = total_give;
+    h->send_buf = (double*) malloc((total_give + 1) * sizeof(double));
+    h->blk_k = 0;
+    h->blk_buf = NULL;
+
+    // 3. Επαναρίθμηση: δυαδική αναζήτηση στα (ταξινομημένα) ghosts
+    for (int k = 0; k < A->nnz; k++) {
+        int c = A->col_ind[k];
+        if (c >= lo && c < hi) {
+            A->col_ind[k] = c - lo;
+        } else {
+            int *p = (int*) bsearch(&c, h->ghost_cols, ng, sizeof(int), cmp_int);
+            A->col_ind[k] = h->local_n + (int) (p - h->ghost_cols);
+        }
+    }
+
+    // 4. Γράφος γειτόνων για το neighborhood collective (βάρη = πλήθος τιμών ανά ακμή)
+    MPI_Dist_graph_create_adjacent(comm, h->nrecv, h->recv_ranks, h->recv_counts,
+                                   h->nsend, h->send_ranks, h->send_counts,
+                                   MPI_INFO_NULL, 0, &h->graph);
+
+    free(need); free(give); free(need_displs); free(give_displs);
+}
+
+void halo_init_x(const halo_t *h, const double *x_global, int lo, double *x_loc) {
+    memcpy(x_loc, x_global + lo, h->local_n * sizeof(double));
+    for (int k = 0; k < h->nghost; k++) x_loc[h->local_n + k] = x_global[h->ghost_cols[k]];
+}
+
+void halo_ibegin(halo_t *h, double *x_loc, MPI_Request *req) {
+    // Πακετάρισμα των τιμών που ζητούν οι γείτονες (με τη σειρά των ghosts τους)
+    for (int k = 0; k < h->nsend_vals; k++) h->send_buf[k] = x_loc[h->send_idx[k]];
+    MPI_Ineighbor_alltoallv(h->send_buf, h->send_counts, h->send_displs, MPI_DOUBLE,
+                            x_loc + h->local_n, h->recv_counts, h->recv_displs, MPI_DOUBLE,
+                            h->graph, req);
+}
+
+void halo_exchange(halo_t *h, double *x_loc) {
+    MPI_Request req;
+    halo_ibegin(h, x_loc, &req);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+}
+
+// Ίδια ανταλλαγή για k διανύσματα (row-major X, local_n + nghost γραμμές των k
+// στοιχείων) με ΕΝΑ Neighbor_alltoallv: ο datatype είναι μία γραμμή του X,
+// οπότε τα counts / displs του setup ισχύουν αυτούσια.
+void halo_exchange_block(halo_t *h, double *X, int k) {
+    if (h->blk_k != k) {
+        if (h->blk_k > 0) MPI_Type_free(&h->blk_type);
+        MPI_Type_contiguous(k, MPI_DOUBLE, &h->blk_type);
+        MPI_Type_commit(&h->blk_type);
+        h->blk_buf = (double*) realloc(h->blk_buf, ((size_t) h->nsend_vals * k + 1) * sizeof(double));
+        h->blk_k = k;
+    }
+    for (int s = 0; s < h->nsend_vals; s++)
+        memcpy(h->blk_buf + (size_t) s * k, X + (size_t) h->send_idx[s] * k, k * sizeof(double));
+    MPI_Neighbor_alltoallv(h->blk_buf, h->send_counts, h->send_displs, h->blk_type,
+                           X + (size_t) h->local_n * k, h->recv_counts, h->recv_displs, h->blk_type,
+                           h->graph);
+}
+
+void halo_free(halo_t *h) {
+    MPI_Comm_free(&h->graph);
+    if (h->blk_k > 0) MPI_Type_free(&h->blk_type);
+    free(h->blk_buf);
+    free(h->ghost_cols); free(h->send_idx); free(h->send_buf);
+    free(h->recv_ranks); free(h->recv_counts); free(h->recv_displs);
+    free(h->send_ranks); free(h->send_counts); free(h->send_displs);
+}
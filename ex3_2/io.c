@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <mpi.h>
+#include "spmv.h"
+
+/* ======================================================
+   Φόρτωση πίνακα από αρχείο (MPI-IO)
+   ======================================================
+   1. Matrix Market (.mtx, coordinate real/integer/pattern, general/symmetric):
+      ο Master διαβάζει μόνο την κεφαλίδα. Το σώμα χωρίζεται σε P ίσα byte
+      ranges, κάθε διεργασία διαβάζει (MPI_File_read_at_all) και αναλύει το
+      δικό της. Μια γραμμή ανήκει στη διεργασία στο range της οποίας ξεκινά.
+      Οι τριάδες (i, j, v) στέλνονται στον ιδιοκτήτη της γραμμής i (Alltoallv)
+      και κάθε διεργασία φτιάχνει το CSR των γραμμών της.
+   2. Native binary CSR (χωρίς ανάλυση κειμένου):
+        [0]   char magic[8] = "CSRBIN1"
+        [8]   int64 n, int64 nnz
+        [24]  int64 row_ptr[n+1]
+              int32 col_ind[nnz]
+              double values[nnz]
+      Κάθε διεργασία διαβάζει το τμήμα row_ptr[lo..hi] και μετά τα
+      col_ind / values [row_ptr[lo], row_ptr[hi]) με συλλογικά read_at_all. */
+
+#define CSRBIN_MAGIC "CSRBIN1"
+#define CSRBIN_HDR   24
+#define MM_OVERLAP   4096        // Μέγιστο μήκος γραμμής δεδομένων του .mtx
+#define MM_HDR_BLOCK 65536       // Ανάγνωση της κεφαλίδας σε μπλοκ
+
+typedef struct {
+    int binary;                  // 1: CSRBIN, 0: Matrix Market
+    int64_t n, nnz;              // nnz: όπως στο αρχείο (symmetric: μόνο το κάτω τρίγωνο)
+    int symmetric, pattern;
+    MPI_Offset data_start;       // Αρχή των δεδομένων
+} mat_hdr_t;
+
+// Κεφαλίδα (μόνο ο Master διαβάζει, μετά Bcast). Επιστρέφει 0 αν είναι έγκυρη.
+static int read_header(MPI_File fh, MPI_Comm comm, mat_hdr_t *h) {
+    int my_rank;
+    MPI_Comm_rank(comm, &my_rank);
+    int ok = 0;
+    memset(h, 0, sizeof(*h));
+
+    if (my_rank == 0) {
+        char *buf = (char*) malloc(MM_HDR_BLOCK + 1);
+        MPI_Status st;
+        int got;
+        MPI_File_read_at(fh, 0, buf, MM_HDR_BLOCK, MPI_CHAR, &st);
+        MPI_Get_count(&st, MPI_CHAR, &got);
+        buf[got] = '\0';
+
+        if (got >= CSRBIN_HDR && memcmp(buf, CSRBIN_MAGIC, 8) == 0) {
+            h->binary = 1;
+            memcpy(&h->n, buf + 8, 8);
+            memcpy(&h->nnz, buf + 16, 8);
+            h->data_start = CSRBIN_HDR;
+            ok = h->n > 0;
+        } else if (strncmp(buf, "%%MatrixMarket", 14) == 0) {
+            char obj[32], fmt[32], field[32], sym[32];
+            char *p = buf;
+            if (sscanf(p, "%%%%MatrixMarket %31s %31s %31s %31s", obj, fmt, field, sym) == 4 &&
+                strcmp(fmt, "coordinate") == 0 && strcmp(field, "complex") != 0) {
+                h->pattern = strcmp(field, "pattern") == 0;
+                h->symmetric = strcmp(sym, "general") != 0;
+                // Παράλειψη σχολίων ως τη γραμμή μεγέθους "M N NZ"
+                while (p && (*p == '%' || *p == '\n')) {
+                    p = strchr(p, '\n');
+                    if (p) p++;
+                }
+                long long M, N, NZ;
+                char *eol = p ? strchr(p, '\n') : NULL;
+                if (eol && sscanf(p, "%lld %lld %lld", &M, &N, &NZ) == 3 && M == N) {
+                    h->n = N;
+                    h->nnz = NZ;
+                    h->data_start = (MPI_Offset) (eol + 1 - buf);
+                    ok = 1;
+                }
+            }
+        }
+        free(buf);
+    }
+
+    MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+    MPI_Bcast(h, sizeof(*h), MPI_BYTE, 0, comm);
+    return ok ? 0 : -1;
+}
+
+int csr_file_dims(const char *path, MPI_Comm comm, int *n, long long *nnz) {
+    MPI_File fh;
+    if (MPI_File_open(comm, path, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) return -1;
+    mat_hdr_t h;
+    int rc = read_header(fh, comm, &h);
+    MPI_File_close(&fh);
+    if (rc != 0) return -1;
+    *n = (int) h.n;
+    *nnz = h.nnz;
+    return 0;
+}
+
+// Ιδιοκτήτης της γραμμής r: το k με row_off[k] <= r < row_off[k+1]
+static int row_owner(int r, const int *row_off, int comm_sz) {
+    int lo = 0, hi = comm_sz - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (row_off[mid] <= r) lo = mid; else hi = mid - 1;
+    }
+    return lo;
+}
+
+typedef struct { int col; double val; } cv_t;
+
+static int cmp_cv(const void *a, const void *b) {
+    int x = ((const cv_t*) a)->col, y = ((const cv_t*) b)->col;
+    return (x > y) - (x < y);
+}
+
+// Τοπικό CSR από τριάδες με global γραμμές στο [lo, lo+rows)
+static csr_t triplets_to_csr(const csr_ij_t *ij, const double *v, int cnt, int lo, int rows) {
+    csr_t A;
+    A.n = rows;
+    A.nnz = cnt;
+    A.row_ptr = (int*) calloc(rows + 1, sizeof(int));
+    A.col_ind = (int*) malloc((cnt + 1) * sizeof(int));
+    A.values = (double*) malloc((cnt + 1) * sizeof(double));
+
+    for (int k = 0; k < cnt; k++) A.row_ptr[ij[k].row - lo + 1]++;
+    for (int i = 0; i < rows; i++) A.row_ptr[i + 1] += A.row_ptr[i];
+
+    // Counting sort ανά γραμμή, μετά ταξινόμηση στηλών μέσα στη γραμμή
+    cv_t *tmp = (cv_t*) malloc((cnt + 1) * sizeof(cv_t));
+    int *pos = (int*) malloc((rows + 1) * sizeof(int));
+    memcpy(pos, A.row_ptr, (rows + 1) * sizeof(int));
+    for (int k = 0; k < cnt; k++) {
+        int p = pos[ij[k].row - lo]++;
+        tmp[p].col = ij[k].col;
+        tmp[p].val = v[k];
+    }
+    #pragma omp parallel for schedule(guided)
+    for (int i = 0; i < rows; i++)
+        qsort(tmp + A.row_ptr[i], A.row_ptr[i + 1] - A.row_ptr[i], sizeof(cv_t), cmp_cv);
+    for (int k = 0; k < cnt; k++) {
+        A.col_ind[k] = tmp[k].col;
+        A.values[k] = tmp[k].val;
+    }
+    free(tmp); free(pos);
+    return A;
+}
+
+/* --- Ανακατανομή τριάδων στους ιδιοκτήτες των γραμμών (Alltoallv) --- */
+csr_t csr_from_triplets(const csr_ij_t *ij, const double *v, size_t cnt, const int *row_off, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+
+    int *scount = (int*) calloc(comm_sz, sizeof(int));
+    int *rcount = (int*) malloc(comm_sz * sizeof(int));
+    int *sdispl = (int*) malloc(comm_sz * sizeof(int));
+    int *rdispl = (int*) malloc(comm_sz * sizeof(int));
+    int *owner = (int*) malloc((cnt + 1) * sizeof(int));
+    for (size_t k = 0; k < cnt; k++) {
+        owner[k] = row_owner(ij[k].row, row_off, comm_sz);
+        scount[owner[k]]++;
+    }
+    MPI_Alltoall(scount, 1, MPI_INT, rcount, 1, MPI_INT, comm);
+    int rtotal = 0;
+    for (int r = 0; r < comm_sz; r++) {
+        sdispl[r] = r > 0 ? sdispl[r - 1] + scount[r - 1] : 0;
+        rdispl[r] = rtotal;
+        rtotal += rcount[r];
+    }
+
+    csr_ij_t *s_ij = (csr_ij_t*) malloc((cnt + 1) * sizeof(csr_ij_t));
+    double *s_v = (double*) malloc((cnt + 1) * sizeof(double));
+    int *fill = (int*) malloc(comm_sz * sizeof(int));
+    memcpy(fill, sdispl, comm_sz * sizeof(int));
+    for (size_t k = 0; k < cnt; k++) {
+        int d = fill[owner[k]]++;
+        s_ij[d] = ij[k];
+        s_v[d] = v[k];
+    }
+    free(owner); free(fill);
+
+    MPI_Datatype ij_type;
+    MPI_Type_contiguous(2, MPI_INT, &ij_type);
+    MPI_Type_commit(&ij_type);
+    csr_ij_t *r_ij = (csr_ij_t*) malloc((rtotal + 1) * sizeof(csr_ij_t));
+    double *r_v = (double*) malloc((rtotal + 1) * sizeof(double));
+    MPI_Alltoallv(s_ij, scount, sdispl, ij_type, r_ij, rcount, rdispl, ij_type, comm);
+    MPI_Alltoallv(s_v, scount, sdispl, MPI_DOUBLE, r_v, rcount, rdispl, MPI_DOUBLE, comm);
+    MPI_Type_free(&ij_type);
+    free(s_ij); free(s_v); free(scount); free(rcount); free(sdispl); free(rdispl);
+
+    int lo = row_off[my_rank];
+    csr_t A = triplets_to_csr(r_ij, r_v, rtotal, lo, row_off[my_rank + 1] - lo);
+    free(r_ij); free(r_v);
+    return A;
+}
+
+// Άκυρο αρχείο: nnz = -1 σε όλες τις διεργασίες
+static csr_t csr_invalid(void) {
+    csr_t E;
+    memset(&E, 0, sizeof(E));
+    E.nnz = -1;
+    return E;
+}
+
+/* --- Matrix Market: παράλληλη ανάγνωση / ανάλυση / ανακατανομή --- */
+static csr_t load_mtx(MPI_File fh, const mat_hdr_t *h, const int *row_off, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+
+    MPI_Offset fsize;
+    MPI_File_get_size(fh, &fsize);
+    MPI_Offset body = fsize - h->data_start;
+    MPI_Offset a = h->data_start + body * my_rank / comm_sz;
+    MPI_Offset b = h->data_start + body * (my_rank + 1) / comm_sz;
+
+    // Διαβάζουμε [a-1, b+MM_OVERLAP): ο χαρακτήρας a-1 δείχνει αν το a είναι αρχή γραμμής,
+    // το overlap ολοκληρώνει την τελευταία γραμμή που ξεκινά πριν το b
+    MPI_Offset r0 = a - 1;
+    MPI_Offset r1 = b + MM_OVERLAP < fsize ? b + MM_OVERLAP : fsize;
+    int len = (int) (r1 - r0);
+    char *buf = (char*) malloc(len + 1);
+    MPI_Status st;
+    MPI_File_read_at_all(fh, r0, buf, len, MPI_CHAR, &st);
+    buf[len] = '\0';
+
+    char *p = buf + 1;                   // Θέση a
+    char *end = buf + (b - r0);          // Θέση b
+    if (buf[0] != '\n') {                // Μέση γραμμής: ανήκει στον προηγούμενο
+        while (p < end && *p != '\n') p++;
+        if (p < end) p++;
+    }
+
+    // Ανάλυση: "i j [v]" με δείκτες από 1. Γραμμή με λείπον πεδίο ή δείκτη εκτός
+    // [1, n] απορρίπτει το αρχείο (αλλιώς ο ιδιοκτήτης γράφει έξω από το row_ptr του).
+    size_t cap = (size_t) (b - a) / 8 + 16, cnt = 0;
+    long long bad = 0, diag = 0;
+    csr_ij_t *ij = (csr_ij_t*) malloc(cap * sizeof(csr_ij_t));
+    double *v = (double*) malloc(cap * sizeof(double));
+    while (p < end) {
+        // Κάθε γραμμή αναλύεται μόνη της (τα strtol / strtod δεν περνούν το '\0')
+        char *eol = p;
+        while (*eol && *eol != '\n') eol++;
+        char save = *eol;
+        *eol = '\0';
+        char *q, *f;
+        long i = strtol(p, &q, 10);
+        int empty = q == p;              // Κενή γραμμή / σχόλιο
+        f = q;
+        long j = strtol(f, &q, 10);
+        int parsed = q != f;
+        double val = 1.0;
+        if (!h->pattern) { f = q; val = strtod(f, &q); parsed = parsed && q != f; }
+        *eol = save;
+        p = save ? eol + 1 : eol;
+        if (empty) continue;
+        if (!parsed || i < 1 || i > h->n || j < 1 || j > h->n) { bad++; continue; }
+        if (i == j) diag++;
+
+        if (cnt + 2 > cap) {
+            cap *= 2;
+            ij = (csr_ij_t*) realloc(ij, cap * sizeof(csr_ij_t));
+            v = (double*) realloc(v, cap * sizeof(double));
+        }
+        ij[cnt].row = (int) i - 1; ij[cnt].col = (int) j - 1; v[cnt] = val; cnt++;
+        if (h->symmetric && i != j) {    // Το πάνω τρίγωνο δεν υπάρχει στο αρχείο
+            ij[cnt].row = (int) j - 1; ij[cnt].col = (int) i - 1; v[cnt] = val; cnt++;
+        }
+    }
+    free(buf);
+
+    // Πλήθος στοιχείων: NZ της κεφαλίδας (symmetric: 2 NZ χωρίς τη διαγώνιο)
+    long long tot[3] = { bad, (long long) cnt, diag };
+    MPI_Allreduce(MPI_IN_PLACE, tot, 3, MPI_LONG_LONG, MPI_SUM, comm);
+    long long expect = h->symmetric ? 2 * h->nnz - tot[2] : h->nnz;
+    if (tot[0] > 0 || tot[1] != expect) {
+        free(ij); free(v);
+        return csr_invalid();
+    }
+
+    csr_t A = csr_from_triplets(ij, v, cnt, row_off, comm);
+    free(ij); free(v);
+    return A;
+}
+
+/* --- Binary CSR: συλλογική ανάγνωση του τμήματος κάθε διεργασίας ---
+ * Ελέγχονται το μέγεθος του αρχείου, το row_ptr (αύξον, μέσα στο [0, nnz]) και
+ * τα col_ind (μέσα στο [0, n)). Η απόφαση είναι συλλογική (Allreduce), ώστε σε
+ * άκυρο αρχείο όλες οι διεργασίες να επιστρέφουν nnz = -1. */
+static csr_t load_bin(MPI_File fh, const mat_hdr_t *h, const int *row_off, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    int lo = row_off[my_rank], rows = row_off[my_rank + 1] - lo;
+
+    // Η κεφαλίδα και το μέγεθος είναι ίδια παντού: δεν χρειάζεται επικοινωνία
+    MPI_Offset fsize;
+    MPI_File_get_size(fh, &fsize);
+    if (h->nnz < 0 || h->nnz > INT_MAX ||
+        fsize < CSRBIN_HDR + (MPI_Offset) (h->n + 1) * 8 + (MPI_Offset) h->nnz * 12)
+        return csr_invalid();
+
+    int64_t *rp = (int64_t*) malloc((rows + 1) * sizeof(int64_t));
+    MPI_File_read_at_all(fh, CSRBIN_HDR + (MPI_Offset) lo * 8, rp, rows + 1, MPI_INT64_T, MPI_STATUS_IGNORE);
+    int bad = rp[0] < 0 || rp[rows] > h->nnz ||
+              (my_rank == 0 && rp[0] != 0) || (my_rank == comm_sz - 1 && rp[rows] != h->nnz);
+    for (int i = 0; i < rows && !bad; i++) bad = rp[i + 1] < rp[i];
+    MPI_Allreduce(MPI_IN_PLACE, &bad, 1, MPI_INT, MPI_MAX, comm);
+    if (bad) {
+        free(rp);
+        return csr_invalid();
+    }
+
+    csr_t A;
+    A.n = rows;
+    A.nnz = (int) (rp[rows] - rp[0]);
+    A.row_ptr = (int*) malloc((rows + 1) * sizeof(int));
+    for (int i = 0; i <= rows; i++) A.row_ptr[i] = (int) (rp[i] - rp[0]);
+    A.col_ind = (int*) malloc((A.nnz + 1) * sizeof(int));
+    A.values = (double*) malloc((A.nnz + 1) * sizeof(double));
+
+    MPI_Offset col_base = CSRBIN_HDR + (MPI_Offset) (h->n + 1) * 8;
+    MPI_Offset val_base = col_base + (MPI_Offset) h->nnz * 4;
+    MPI_File_read_at_all(fh, col_base + (MPI_Offset) rp[0] * 4, A.col_ind, A.nnz, MPI_INT, MPI_STATUS_IGNORE);
+    MPI_File_read_at_all(fh, val_base + (MPI_Offset) rp[0] * 8, A.values, A.nnz, MPI_DOUBLE, MPI_STATUS_IGNORE);
+    free(rp);
+
+    for (int k = 0; k < A.nnz && !bad; k++) bad = A.col_ind[k] < 0 || A.col_ind[k] >= h->n;
+    MPI_Allreduce(MPI_IN_PLACE, &bad, 1, MPI_INT, MPI_MAX, comm);
+    if (bad) {
+        free(A.row_ptr); free(A.col_ind); free(A.values);
+        return csr_invalid();
+    }
+    return A;
+}
+
+// Αποτυχία ανοίγματος / άκυρη κεφαλίδα / διαφορετικό n: nnz = -1
+csr_t csr_load(const char *path, const int *row_off, MPI_Comm comm) {
+    int comm_sz;
+    MPI_Comm_size(comm, &comm_sz);
+    MPI_File fh;
+    mat_hdr_t h;
+    if (MPI_File_open(comm, path, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+        return csr_invalid();
+    if (read_header(fh, comm, &h) != 0 || h.n != row_off[comm_sz]) {
+        MPI_File_close(&fh);
+        return csr_invalid();
+    }
+    csr_t A = h.binary ? load_bin(fh, &h, row_off, comm) : load_mtx(fh, &h, row_off, comm);
+    MPI_File_close(&fh);
+    return A;
+}
+
+/* --- Αποθήκευση σε binary CSR (κάθε διεργασία γράφει το τμήμα της) --- */
+int csr_save(const char *path, const csr_t *A, const int *row_off, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    int lo = row_off[my_rank];
+    int64_t n = row_off[comm_sz];
+
+    // Global θέση των μη-μηδενικών μας και συνολικό nnz
+    int64_t my_nnz = A->nnz, first = 0, total = 0;
+    MPI_Exscan(&my_nnz, &first, 1, MPI_INT64_T, MPI_SUM, comm);
+    if (my_rank == 0) first = 0;
+    MPI_Allreduce(&my_nnz, &total, 1, MPI_INT64_T, MPI_SUM, comm);
+
+    MPI_File fh;
+    if (MPI_File_open(comm, path, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+        return -1;
+    MPI_File_set_size(fh, 0);
+
+    char hdr[CSRBIN_HDR] = CSRBIN_MAGIC;
+    memcpy(hdr + 8, &n, 8);
+    memcpy(hdr + 16, &total, 8);
+    MPI_File_write_at_all(fh, 0, hdr, my_rank == 0 ? CSRBIN_HDR : 0, MPI_BYTE, MPI_STATUS_IGNORE);
+
+    // row_ptr: οι γραμμές μας, και η τελευταία διεργασία γράφει και το row_ptr[n]
+    int cnt = A->n + (my_rank == comm_sz - 1);
+    int64_t *rp = (int64_t*) malloc((A->n + 1) * sizeof(int64_t));
+    for (int i = 0; i <= A->n; i++) rp[i] = first + A->row_ptr[i];
+    MPI_File_write_at_all(fh, CSRBIN_HDR + (MPI_Offset) lo * 8, rp, cnt, MPI_INT64_T, MPI_STATUS_IGNORE);
+    free(rp);
+
+    MPI_Offset col_base = CSRBIN_HDR + (MPI_Offset) (n + 1) * 8;
+    MPI_Offset val_base = col_base + (MPI_Offset) total * 4;
+    MPI_File_write_at_all(fh, col_base + (MPI_Offset) first * 4, A->col_ind, A->nnz, MPI_INT, MPI_STATUS_IGNORE);
+    MPI_File_write_at_all(fh, val_base + (MPI_Offset) first * 8, A->values, A->nnz, MPI_DOUBLE, MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+    return 0;
+}
@@ -0,0 +1,275 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include "spmv.h"
+#include "timer.h"
+
+/* ======================================================
+   Επιλυτές πάνω στο κατανεμημένο SpMV
+   ======================================================
+   Όλα τα διανύσματα είναι κατανεμημένα όπως το y (local_n στοιχεία ανά
+   διεργασία). Κάθε εφαρμογή του A ανανεώνει πρώτα το x με την ανταλλαγή του
+   βρόχου (allgather ή halo) και μετά τρέχει τον πυρήνα (CSR ή SELL).
+
+   - CG: 1 SpMV και 2 ανασταλτικά Allreduce ανά επανάληψη ((p, Ap) και (r, r)).
+   - Pipelined CG (Ghysels & Vanroose): τα δύο εσωτερικά γινόμενα (r, r) και
+     (w, r) μαζεύονται σε ΕΝΑ MPI_Iallreduce, που εξελίσσεται όσο υπολογίζεται
+     το q = A w. Κοστίζει 3 επιπλέον AXPY ανά επανάληψη.
+   - Breakdown (CG / pipecg): αν ο A δεν είναι SPD το (p, Ap) (αντίστοιχα το
+     (w, r)) μπορεί να μηδενιστεί ή να γίνει αρνητικό και το α να βγει άπειρο
+     ή NaN. Ο επιλυτής σταματά εκεί και το δηλώνει (ποτέ "converged").
+   - Power iteration: y = A x, λ = (x, y), x = y / ||y|| με ένα Allreduce
+     δύο τιμών ανά επανάληψη. ||y - λ x||^2 = (y, y) - λ^2 αφού ||x|| = 1. */
+
+typedef struct {
+    const csr_t *A;
+    const sell_t *sell;        // NULL -> πυρήνας CSR
+    exch_mode_t mode;
+    halo_t *halo;
+    int local_n;
+    int *counts;               // allgather: γραμμές ανά διεργασία
+    const int *row_off;
+    double *xbuf;              // allgather: n στοιχεία, halo: local_n + nghost
+    MPI_Comm comm;
+} spmv_op_t;
+
+// y = A * v (v, y: τοπικά τμήματα)
+static void op_apply(spmv_op_t *op, const double *v, double *y) {
+    int local_n = op->local_n;
+    if (op->mode == EXCH_HALO) {
+        memcpy(op->xbuf, v, local_n * sizeof(double));
+        halo_exchange(op->halo, op->xbuf);
+    } else {
+        MPI_Allgatherv(v, local_n, MPI_DOUBLE, op->xbuf, op->counts, op->row_off, MPI_DOUBLE, op->comm);
+    }
+
+    if (op->sell) {
+        sell_spmv(op->sell, op->xbuf, y);
+        return;
+    }
+    const csr_t *A = op->A;
+    #pragma omp parallel for schedule(guided)
+    for (int i = 0; i < local_n; i++) {
+        double sum = 0.0;
+        for (int j = A->row_ptr[i]; j < A->row_ptr[i + 1]; j++) sum += A->values[j] * op->xbuf[A->col_ind[j]];
+        y[i] = sum;
+    }
+}
+
+static double dot(const double *a, const double *b, int m) {
+    double s = 0.0;
+    #pragma omp parallel for reduction(+:s) schedule(static)
+    for (int i = 0; i < m; i++) s += a[i] * b[i];
+    return s;
+}
+
+/* --- CG --- */
+static void solve_cg(spmv_op_t *op, const double *b, double *x, int maxit, double tol, krylov_result_t *res) {
+    int m = op->local_n;
+    double *r = (double*) malloc((m + 1) * sizeof(double));
+    double *p = (double*) malloc((m + 1) * sizeof(double));
+    double *Ap = (double*) malloc((m + 1) * sizeof(double));
+
+    // x0 = 0 -> r0 = p0 = b
+    memset(x, 0, m * sizeof(double));
+    memcpy(r, b, m * sizeof(double));
+    memcpy(p, b, m * sizeof(double));
+    double rr = dot(r, r, m), bb;
+    MPI_Allreduce(MPI_IN_PLACE, &rr, 1, MPI_DOUBLE, MPI_SUM, op->comm);
+    bb = rr > 0.0 ? rr : 1.0;
+
+    int it = 0;
+    while (it < maxit && sqrt(rr / bb) > tol) {
+        op_apply(op, p, Ap);
+        double pAp = dot(p, Ap, m);
+        MPI_Allreduce(MPI_IN_PLACE, &pAp, 1, MPI_DOUBLE, MPI_SUM, op->comm);
+        double alpha = rr / pAp;
+        if (!(pAp > 0.0) || !isfinite(alpha)) { res->breakdown = 1; break; }   // Ίδιο σε όλες τις διεργασίες
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < m; i++) { x[i] += alpha * p[i]; r[i] -= alpha * Ap[i]; }
+
+        double rr_new = dot(r, r, m);
+        MPI_Allreduce(MPI_IN_PLACE, &rr_new, 1, MPI_DOUBLE, MPI_SUM, op->comm);
+        double beta = rr_new / rr;
+        rr = rr_new;
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < m; i++) p[i] = r[i] + beta * p[i];
+        it++;
+    }
+
+    res->iters = it;
+    res->resid = sqrt(rr / bb);
+    res->reductions = 2;
+    free(r); free(p); free(Ap);
+}
+
+/* --- Pipelined CG --- */
+static void solve_pipecg(spmv_op_t *op, const double *b, double *x, int maxit, double tol, krylov_result_t *res) {
+    int m = op->local_n;
+    size_t sz = (m + 1) * sizeof(double);
+    double *r = malloc(sz), *w = malloc(sz), *q = malloc(sz);
+    double *z = calloc(m + 1, sizeof(double)), *s = calloc(m + 1, sizeof(double)), *p = calloc(m + 1, sizeof(double));
+
+    // x0 = 0 -> r0 = b, w0 = A r0
+    memset(x, 0, m * sizeof(double));
+    memcpy(r, b, m * sizeof(double));
+    op_apply(op, r, w);
+    double bb = dot(b, b, m);
+    MPI_Allreduce(MPI_IN_PLACE, &bb, 1, MPI_DOUBLE, MPI_SUM, op->comm);
+    if (bb <= 0.0) bb = 1.0;
+
+    double gamma_prev = 0.0, alpha_prev = 0.0, rr = bb;
+    int it = 0;
+    while (it < maxit) {
+        // γ = (r, r), δ = (w, r): ένα μη-ανασταλτικό Allreduce...
+        double loc[2] = { dot(r, r, m), dot(w, r, m) }, glob[2];
+        MPI_Request req;
+        MPI_Iallreduce(loc, glob, 2, MPI_DOUBLE, MPI_SUM, op->comm, &req);
+
+        // ...που επικαλύπτεται με το SpMV q = A w (η ανταλλαγή του x το προωθεί)
+        op_apply(op, w, q);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+
+        double gamma = glob[0], delta = glob[1];
+        rr = gamma;
+        if (sqrt(rr / bb) <= tol) break;   // ||r_i|| (ο έλεγχος γίνεται με το γ της επανάληψης)
+
+        double beta, alpha;
+        if (it == 0) { beta = 0.0; alpha = gamma / delta; }
+        else { beta = gamma / gamma_prev; alpha = gamma / (delta - beta * gamma / alpha_prev); }
+        if (!(delta > 0.0) || !(alpha > 0.0) || !isfinite(alpha)) { res->breakdown = 1; break; }
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < m; i++) {
+            z[i] = q[i] + beta * z[i];
+            s[i] = w[i] + beta * s[i];
+            p[i] = r[i] + beta * p[i];
+            x[i] += alpha * p[i];
+            r[i] -= alpha * s[i];
+            w[i] -= alpha * z[i];
+        }
+        gamma_prev = gamma;
+        alpha_prev = alpha;
+        it++;
+    }
+
+    res->iters = it;
+    res->resid = sqrt(rr / bb);
+    res->reductions = 1;
+    free(r); free(w); free(q); free(z); free(s); free(p);
+}
+
+/* --- Normalized power iteration ---
+ * Το υπόλοιπο ||y - λx|| υπολογίζεται απευθείας, όχι ως (y,y) - λ^2 που χάνει
+ * όλα τα ψηφία όταν σύγκλινει. Για να μείνει ένα Allreduce ανά επανάληψη
+ * χρησιμοποιείται το λ της προηγούμενης επανάληψης· επειδή το λ = (x,y)
+ * ελαχιστοποιεί το ||y - μx|| για ||x|| = 1, η εκτίμηση είναι συντηρητική. */
+static void solve_power(spmv_op_t *op, double *x, int maxit, double tol, krylov_result_t *res) {
+    int m = op->local_n;
+    int comm_sz;
+    MPI_Comm_size(op->comm, &comm_sz);
+    double *y = (double*) malloc((m + 1) * sizeof(double));
+
+    // x0 = 1 / sqrt(n)
+    int n = op->row_off[comm_sz];
+    for (int i = 0; i < m; i++) x[i] = 1.0 / sqrt((double) n);
+
+    double lambda = 0.0, resid = 1.0;
+    int it = 0;
+    while (it < maxit) {
+        op_apply(op, x, y);
+        double xy = 0.0, yy = 0.0, rr = 0.0;
+        #pragma omp parallel for reduction(+:xy,yy,rr) schedule(static)
+        for (int i = 0; i < m; i++) {
+            double d = y[i] - lambda * x[i];
+            xy += x[i] * y[i];
+            yy += y[i] * y[i];
+            rr += d * d;
+        }
+        double loc[3] = { xy, yy, rr }, glob[3];
+        MPI_Allreduce(loc, glob, 3, MPI_DOUBLE, MPI_SUM, op->comm);
+        lambda = glob[0];
+        double ny = sqrt(glob[1]);
+        resid = sqrt(glob[2]) / (fabs(lambda) > 0.0 ? fabs(lambda) : 1.0);
+        it++;
+        if (ny == 0.0) break;
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < m; i++) x[i] = y[i] / ny;
+        if (resid <= tol) break;
+    }
+
+    res->iters = it;
+    res->resid = resid;
+    res->lambda = lambda;
+    res->reductions = 1;
+    free(y);
+}
+
+const char *solver_name(solver_t s) {
+    switch (s) {
+        case SOLVER_CG:     return "cg";
+        case SOLVER_PIPECG: return "pipecg";
+        case SOLVER_POWER:  return "power";
+        default:            return "none";
+    }
+}
+
+void krylov_solve(solver_t solver, const csr_t *A, const sell_t *sell, exch_mode_t mode, halo_t *halo,
+                  const int *row_off, int maxit, double tol, MPI_Comm comm, krylov_result_t *res) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    int n = row_off[comm_sz], m = A->n;
+
+    spmv_op_t op = { A, sell, mode, halo, m, NULL, row_off, NULL, comm };
+    if (mode == EXCH_HALO) {
+        op.xbuf = (double*) malloc((m + halo->nghost + 1) * sizeof(double));
+    } else {
+        op.xbuf = (double*) malloc(n * sizeof(double));
+        op.counts = (int*) malloc(comm_sz * sizeof(int));
+        for (int r = 0; r < comm_sz; r++) op.counts[r] = row_off[r + 1] - row_off[r];
+    }
+
+    double *x = (double*) malloc((m + 1) * sizeof(double));
+    double *b = (double*) malloc((m + 1) * sizeof(double));
+    double *ones = (double*) malloc((m + 1) * sizeof(double));
+    memset(res, 0, sizeof(*res));
+
+    // Γραμμικά συστήματα: b = A * 1, άρα η ακριβής λύση είναι το διάνυσμα μονάδων
+    if (solver != SOLVER_POWER) {
+        for (int i = 0; i < m; i++) ones[i] = 1.0;
+        op_apply(&op, ones, b);
+    }
+
+    double t0, t1;
+    MPI_Barrier(comm);
+    GET_TIME(t0);
+    if (solver == SOLVER_CG) solve_cg(&op, b, x, maxit, tol, res);
+    else if (solver == SOLVER_PIPECG) solve_pipecg(&op, b, x, maxit, tol, res);
+    else solve_power(&op, x, maxit, tol, res);
+    MPI_Barrier(comm);
+    GET_TIME(t1);
+    res->time = t1 - t0;
+    res->converged = !res->breakdown && res->resid <= tol;
+
+    // Το NaN περνά στο max (!(d <= err)) και, επειδή το MPI_MAX μπορεί να το
+    // αγνοήσει, μεταφέρεται και ως σημαία
+    if (solver != SOLVER_POWER) {
+        double err = 0.0;
+        for (int i = 0; i < m; i++) {
+            double d = fabs(x[i] - 1.0);
+            if (!(d <= err)) err = d;
+        }
+        int nan_loc = isnan(err), nan_any;
+        MPI_Allreduce(&err, &res->err, 1, MPI_DOUBLE, MPI_MAX, comm);
+        MPI_Allreduce(&nan_loc, &nan_any, 1, MPI_INT, MPI_MAX, comm);
+        if (nan_any) res->err = NAN;
+    }
+
+    free(x); free(b); free(ones); free(op.xbuf); free(op.counts);
+}
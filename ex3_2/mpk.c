@@ -0,0 +1,253 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include "spmv.h"
+#include "timer.h"
+
+/* ======================================================
+   Matrix powers (s-step): A x, A^2 x, ..., A^s x με μία ανταλλαγή
+   ======================================================
+   Ο βρόχος SpMV πληρώνει μία ανταλλαγή (latency) ανά επανάληψη. Εδώ κάθε
+   διεργασία κρατά, εκτός από τις γραμμές της, και τις ξένες γραμμές που
+   χρειάζεται για s βήματα χωρίς επικοινωνία:
+     R_0 = δικές μας γραμμές, R_k = R_{k-1} ∪ cols(R_{k-1}).
+   Για το A^s x στο R_0 χρειάζεται το A^{s-1} x στο R_1, ..., το x στο R_s.
+   Το βήμα j (1..s) υπολογίζει τις γραμμές του R_{s-j} (πλεονάζουσες πράξεις
+   για τις ξένες), άρα αρκεί ΜΙΑ ανταλλαγή του x στο R_s \ R_0 ανά s βήματα.
+
+   Setup (συλλογική): τα επίπεδα βγαίνουν από το col_ind. Οι γραμμές του
+   επιπέδου k (k < s) ζητούνται από τους ιδιοκτήτες τους (Alltoallv) και οι
+   στήλες τους δίνουν το επίπεδο k + 1. Ο εκτεταμένος πίνακας E έχει τις
+   γραμμές του R_{s-1} ταξινομημένες κατά επίπεδο, οπότε το R_k είναι οι
+   πρώτες lvl_rows[k] γραμμές του. Η ανταλλαγή είναι το halo του E: τα ghosts
+   του είναι ακριβώς το R_s \ R_0. */
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+// Ιδιοκτήτης της γραμμής c: το r με row_off[r] <= c < row_off[r+1]
+static int owner_of(int c, const int *row_off, int comm_sz) {
+    int lo = 0, hi = comm_sz - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (row_off[mid] <= c) lo = mid; else hi = mid - 1;
+    }
+    return lo;
+}
+
+// Συλλογική: οι γραμμές req (ταξινομημένες, global) από τους ιδιοκτήτες τους.
+// Επιστρέφει CSR με nreq γραμμές στη σειρά του req και global στήλες.
+static csr_t fetch_rows(const csr_t *A, int lo, const int *row_off, const int *req, int nreq, MPI_Comm comm) {
+    int comm_sz;
+    MPI_Comm_size(comm, &comm_sz);
+    int *cnt = (int*) calloc(6 * comm_sz, sizeof(int));
+    int *need = cnt, *need_d = cnt + comm_sz, *give = cnt + 2 * comm_sz, *give_d = cnt + 3 * comm_sz;
+    int *vr = cnt + 4 * comm_sz, *vs = cnt + 5 * comm_sz;   // nnz ανά διεργασία (λήψη / αποστολή)
+
+    // 1. Ποιες γραμμές ζητάμε από ποιον
+    for (int k = 0; k < nreq; k++) need[owner_of(req[k], row_off, comm_sz)]++;
+    MPI_Alltoall(need, 1, MPI_INT, give, 1, MPI_INT, comm);
+    int ngive = 0;
+    for (int r = 0; r < comm_sz; r++) {
+        need_d[r] = r > 0 ? need_d[r - 1] + need[r - 1] : 0;
+        give_d[r] = ngive;
+        ngive += give[r];
+    }
+    int *ids = (int*) malloc((ngive + 1) * sizeof(int));
+    MPI_Alltoallv(req, need, need_d, MPI_INT, ids, give, give_d, MPI_INT, comm);
+
+    // 2. Μήκη των γραμμών (στη σειρά του αιτήματος)
+    int *glen = (int*) malloc((ngive + 1) * sizeof(int));
+    for (int k = 0; k < ngive; k++) {
+        int i = ids[k] - lo;
+        glen[k] = A->row_ptr[i + 1] - A->row_ptr[i];
+    }
+    csr_t B;
+    B.n = nreq;
+    B.row_ptr = (int*) malloc((nreq + 1) * sizeof(int));
+    MPI_Alltoallv(glen, give, give_d, MPI_INT, B.row_ptr + 1, need, need_d, MPI_INT, comm);
+    B.row_ptr[0] = 0;
+    for (int k = 0; k < nreq; k++) B.row_ptr[k + 1] += B.row_ptr[k];
+    B.nnz = B.row_ptr[nreq];
+
+    // 3. Στήλες και τιμές
+    int nsend = 0;
+    for (int r = 0; r < comm_sz; r++)
+        for (int k = give_d[r]; k < give_d[r] + give[r]; k++) { vs[r] += glen[k]; nsend += glen[k]; }
+    for (int r = 0; r < comm_sz; r++)
+        vr[r] = B.row_ptr[need_d[r] + need[r]] - B.row_ptr[need_d[r]];
+    int *scols = (int*) malloc((nsend + 1) * sizeof(int));
+    double *svals = (double*) malloc((nsend + 1) * sizeof(double));
+    for (int k = 0, p = 0; k < ngive; k++) {
+        int i = ids[k] - lo;
+        memcpy(scols + p, A->col_ind + A->row_ptr[i], glen[k] * sizeof(int));
+        memcpy(svals + p, A->values + A->row_ptr[i], glen[k] * sizeof(double));
+        p += glen[k];
+    }
+    int *sd = (int*) malloc(2 * comm_sz * sizeof(int)), *rd = sd + comm_sz;
+    for (int r = 0; r < comm_sz; r++) {
+        sd[r] = r > 0 ? sd[r - 1] + vs[r - 1] : 0;
+        rd[r] = r > 0 ? rd[r - 1] + vr[r - 1] : 0;
+    }
+    B.col_ind = (int*) malloc((B.nnz + 1) * sizeof(int));
+    B.values = (double*) malloc((B.nnz + 1) * sizeof(double));
+    MPI_Alltoallv(scols, vs, sd, MPI_INT, B.col_ind, vr, rd, MPI_INT, comm);
+    MPI_Alltoallv(svals, vs, sd, MPI_DOUBLE, B.values, vr, rd, MPI_DOUBLE, comm);
+
+    free(cnt); free(ids); free(glen); free(scols); free(svals); free(sd);
+    return B;
+}
+
+void mpk_setup(mpk_t *m, const csr_t *A, const int *row_off, int s, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    int n = row_off[comm_sz], lo = row_off[my_rank], local_n = A->n;
+
+    m->s = s;
+    m->local_n = local_n;
+    m->lvl_rows = (int*) malloc((s + 1) * sizeof(int));
+    m->lvl_rows[0] = local_n;
+
+    // Global δείκτες που ανήκουν ήδη σε κάποιο επίπεδο
+    signed char *seen = (signed char*) calloc(n, 1);
+    for (int i = lo; i < lo + local_n; i++) seen[i] = 1;
+
+    // E = [δικές μας γραμμές | επίπεδο 1 | ... | επίπεδο s-1], global στήλες
+    size_t cap_n = local_n + 1, cap_nnz = A->nnz + 1;
+    csr_t E = { (double*) malloc(cap_nnz * sizeof(double)), (int*) malloc(cap_nnz * sizeof(int)),
+                (int*) malloc((cap_n + 1) * sizeof(int)), local_n, A->nnz };
+    memcpy(E.values, A->values, A->nnz * sizeof(double));
+    memcpy(E.col_ind, A->col_ind, A->nnz * sizeof(int));
+    memcpy(E.row_ptr, A->row_ptr, (local_n + 1) * sizeof(int));
+    m->row_g = (int*) malloc(cap_n * sizeof(int));
+    for (int i = 0; i < local_n; i++) m->row_g[i] = lo + i;
+
+    int first = 0;   // Πρώτη γραμμή του E στο τελευταίο επίπεδο (το "μέτωπο")
+    for (int k = 1; k < s; k++) {
+        // Νέοι δείκτες: στήλες του μετώπου που δεν έχουμε δει
+        int *req = (int*) malloc((E.row_ptr[E.n] - E.row_ptr[first] + 1) * sizeof(int));
+        int nreq = 0;
+        for (int j = E.row_ptr[first]; j < E.row_ptr[E.n]; j++) {
+            int c = E.col_ind[j];
+            if (!seen[c]) { seen[c] = 1; req[nreq++] = c; }
+        }
+        qsort(req, nreq, sizeof(int), cmp_int);
+        csr_t B = fetch_rows(A, lo, row_off, req, nreq, comm);
+
+        // Προσάρτηση στο E
+        if ((size_t) E.n + nreq + 1 > cap_n) {
+            cap_n = 2 * ((size_t) E.n + nreq + 1);
+            E.row_ptr = (int*) realloc(E.row_ptr, (cap_n + 1) * sizeof(int));
+            m->row_g = (int*) realloc(m->row_g, cap_n * sizeof(int));
+        }
+        if ((size_t) E.nnz + B.nnz + 1 > cap_nnz) {
+            cap_nnz = 2 * ((size_t) E.nnz + B.nnz + 1);
+            E.values = (double*) realloc(E.values, cap_nnz * sizeof(double));
+            E.col_ind = (int*) realloc(E.col_ind, cap_nnz * sizeof(int));
+        }
+        memcpy(E.values + E.nnz, B.values, B.nnz * sizeof(double));
+        memcpy(E.col_ind + E.nnz, B.col_ind, B.nnz * sizeof(int));
+        for (int i = 0; i < nreq; i++) {
+            E.row_ptr[E.n + i + 1] = E.nnz + B.row_ptr[i + 1];
+            m->row_g[E.n + i] = req[i];
+        }
+        first = E.n;
+        E.n += nreq;
+        E.nnz += B.nnz;
+        m->lvl_rows[k] = E.n;
+        free_csr(&B); free(req);
+    }
+    m->lvl_rows[s] = E.n;   // Το R_s \ R_{s-1} χρειάζεται μόνο ως τιμές του x (ghosts)
+
+    // Ανταλλαγή: ghosts του E = R_s \ R_0. Το halo_setup επαναριθμεί τις στήλες
+    // (δικές μας -> 0..local_n-1, ghost k -> local_n + k)
+    halo_setup(&m->halo, &E, row_off, comm);
+    m->E = E;
+
+    // Θέση κάθε γραμμής του E στο τοπικό x: οι ξένες γραμμές είναι ghosts του E
+    m->row_x = (int*) malloc((E.n + 1) * sizeof(int));
+    for (int i = 0; i < E.n; i++) {
+        if (i < local_n) { m->row_x[i] = i; continue; }
+        int *p = (int*) bsearch(&m->row_g[i], m->halo.ghost_cols, m->halo.nghost, sizeof(int), cmp_int);
+        m->row_x[i] = local_n + (int) (p - m->halo.ghost_cols);
+    }
+
+    size_t len = (size_t) local_n + m->halo.nghost + 1;
+    m->buf[0] = (double*) malloc(len * sizeof(double));
+    m->buf[1] = (double*) malloc(len * sizeof(double));
+    free(seen);
+}
+
+void mpk_free(mpk_t *m) {
+    halo_free(&m->halo);
+    free_csr(&m->E);
+    free(m->lvl_rows); free(m->row_g); free(m->row_x);
+    free(m->buf[0]); free(m->buf[1]);
+}
+
+// Γύρος t <= s βημάτων από το x (δικές μας τιμές + ghosts). Το βήμα j υπολογίζει
+// τις γραμμές του R_{t-j}. Επιστρέφει τον buffer με το αποτέλεσμα.
+static int mpk_round(mpk_t *m, int cur, int t, long long *nnz_done) {
+    const csr_t *E = &m->E;
+    for (int j = 1; j <= t; j++) {
+        const double *x = m->buf[cur];
+        double *y = m->buf[1 - cur];
+        int rows = m->lvl_rows[t - j];
+        #pragma omp parallel for schedule(guided)
+        for (int i = 0; i < rows; i++) {
+            double sum = 0.0;
+            for (int k = E->row_ptr[i]; k < E->row_ptr[i + 1]; k++) sum += E->values[k] * x[E->col_ind[k]];
+            y[m->row_x[i]] = sum;
+        }
+        *nnz_done += E->row_ptr[rows];
+        cur = 1 - cur;
+    }
+    return cur;
+}
+
+void mpk_run(mpk_t *m, const double *x0, int lo, int iters, const double *y_ref,
+             MPI_Comm comm, mpk_result_t *res) {
+    int local_n = m->local_n;
+    long long nnz_done = 0;
+    double t0, t1;
+    int cur = 0;
+    memcpy(m->buf[0], x0 + lo, local_n * sizeof(double));
+
+    res->s = m->s;
+    res->nexch = 0;
+    MPI_Barrier(comm);
+    GET_TIME(t0);
+    for (int done = 0; done < iters; ) {
+        int t = iters - done < m->s ? iters - done : m->s;
+        halo_exchange(&m->halo, m->buf[cur]);
+        cur = mpk_round(m, cur, t, &nnz_done);
+        res->nexch++;
+        done += t;
+    }
+    MPI_Barrier(comm);
+    GET_TIME(t1);
+    res->time = t1 - t0;
+
+    // Πλεονάζουσες πράξεις ως προς iters SpMV, μηνύματα και ghosts (global)
+    long long loc[4] = { nnz_done, (long long) iters * m->E.row_ptr[local_n],
+                         (long long) m->halo.nrecv * res->nexch, m->halo.nghost }, glob[4];
+    MPI_Allreduce(loc, glob, 4, MPI_LONG_LONG, MPI_SUM, comm);
+    res->extra = glob[1] > 0 ? (double) glob[0] / glob[1] - 1.0 : 0.0;
+    res->msgs = glob[2];
+    res->ghosts = glob[3];
+
+    // Έλεγχος έναντι του βρόχου SpMV (ως προς τη νόρμα max, όπως ο Check)
+    const double *y = m->buf[cur];
+    double e[2] = { 1.0, 0.0 };
+    for (int i = 0; i < local_n; i++) if (fabs(y_ref[i]) > e[0]) e[0] = fabs(y_ref[i]);
+    MPI_Allreduce(MPI_IN_PLACE, &e[0], 1, MPI_DOUBLE, MPI_MAX, comm);
+    for (int i = 0; i < local_n; i++) {
+        double d = fabs(y[i] - y_ref[i]) / e[0];
+        if (d > e[1]) e[1] = d;
+    }
+    MPI_Allreduce(&e[1], &res->err, 1, MPI_DOUBLE, MPI_MAX, comm);
+}
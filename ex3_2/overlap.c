@@ -0,0 +1,227 @@
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "spmv.h"
+#include "timer.h"
+
+/* ======================================================
+   Επικάλυψη επικοινωνίας / υπολογισμού
+   ======================================================
+   Οι γραμμές κάθε διεργασίας χωρίζονται σε:
+   - interior: διαβάζουν ΜΟΝΟ δικά μας στοιχεία του x, τα οποία είναι ήδη
+     γνωστά (= το local_y της προηγούμενης επανάληψης),
+   - boundary: διαβάζουν και ξένα στοιχεία.
+   Επανάληψη k: εκκίνηση μη-ανασταλτικής ανανέωσης του x με το y_{k-1}
+   (Iallgather ή Ineighbor_alltoallv) | interior γραμμές | Wait | boundary.
+   Οι διαδοχικές τιμές του x είναι ίδιες με τον ανασταλτικό βρόχο.
+   Χωρίς ασύγχρονη πρόοδο στη βιβλιοθήκη MPI η επικοινωνία προχωρά μόνο μέσα
+   σε κλήσεις MPI, οπότε ο interior υπολογισμός γίνεται σε τμήματα με
+   MPI_Test ανάμεσα. */
+
+#define OVL_CHUNKS 8   // Τμήματα του interior υπολογισμού (MPI_Test ανάμεσα)
+
+static double now(void) {
+    double stamp;
+    GET_TIME(stamp);
+    return stamp;
+}
+
+// y[rows[k]] (= ή +=) Σ values * x[col - xoff] για τις γραμμές της λίστας
+static void spmv_rows(const csr_t *A, const int *rows, int nrows,
+                      const double *x, int xoff, double *y) {
+    #pragma omp parallel for schedule(guided)
+    for (int k = 0; k < nrows; k++) {
+        int i = rows[k];
+        double sum = 0.0;
+        for (int j = A->row_ptr[i]; j < A->row_ptr[i + 1]; j++)
+            sum += A->values[j] * x[A->col_ind[j] - xoff];
+        y[i] = sum;
+    }
+}
+
+// Interior γραμμές σε OVL_CHUNKS τμήματα, με MPI_Test για πρόοδο της επικοινωνίας
+static void spmv_rows_progress(const csr_t *A, const int *rows, int nrows,
+                               const double *x, int xoff, double *y, MPI_Request *req) {
+    int flag = 0;
+    for (int c = 0; c < OVL_CHUNKS; c++) {
+        int k0 = (int) ((long long) c * nrows / OVL_CHUNKS);
+        int k1 = (int) ((long long) (c + 1) * nrows / OVL_CHUNKS);
+        spmv_rows(A, rows + k0, k1 - k0, x, xoff, y);
+        if (!flag) MPI_Test(req, &flag, MPI_STATUS_IGNORE);
+    }
+}
+
+void ovl_split(ovl_split_t *s, const csr_t *A, int col_lo, int col_hi) {
+    s->n_int = s->n_bnd = 0;
+    s->rows_int = (int*) malloc((A->n + 1) * sizeof(int));
+    s->rows_bnd = (int*) malloc((A->n + 1) * sizeof(int));
+    for (int i = 0; i < A->n; i++) {
+        int inner = 1;
+        for (int j = A->row_ptr[i]; j < A->row_ptr[i + 1] && inner; j++)
+            inner = A->col_ind[j] >= col_lo && A->col_ind[j] < col_hi;
+        if (inner) s->rows_int[s->n_int++] = i;
+        else s->rows_bnd[s->n_bnd++] = i;
+    }
+}
+
+void ovl_split_free(ovl_split_t *s) {
+    free(s->rows_int); free(s->rows_bnd);
+}
+
+/* --- Έναρξη ανανέωσης του x από το (δικό μας) y --- */
+// counts: γραμμές ανά διεργασία (part_counts), displs = row_off
+static void exch_begin(exch_mode_t mode, halo_t *halo, const double *y, double *x,
+                       const int *counts, const int *row_off, MPI_Request *req) {
+    int my_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    int local_n = counts[my_rank];
+    if (mode == EXCH_HALO) {
+        memcpy(x, y, local_n * sizeof(double));   // Τα δικά μας δεν είναι μέρος του recv buffer
+        halo_ibegin(halo, x, req);
+    } else {
+        MPI_Iallgatherv(y, local_n, MPI_DOUBLE, x, counts, row_off, MPI_DOUBLE, MPI_COMM_WORLD, req);
+    }
+}
+
+double ovl_calibrate(exch_mode_t mode, halo_t *halo, const double *x, int n, const int *row_off) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+    int lo = row_off[my_rank], local_n = row_off[my_rank + 1] - lo;
+    int *counts = part_counts(row_off, comm_sz);
+    // Μέσος χρόνος μίας ανασταλτικής ανταλλαγής (σε αντίγραφο, το x δεν αλλάζει)
+    int len = mode == EXCH_HALO ? local_n + halo->nghost : n;
+    double *scratch = (double*) malloc((len + 1) * sizeof(double));
+    memcpy(scratch, x, len * sizeof(double));
+    const double *y = mode == EXCH_HALO ? x : x + lo;
+    MPI_Request req;
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = now();
+    for (int r = 0; r < OVL_CALIB_REPS; r++) {
+        exch_begin(mode, halo, y, scratch, counts, row_off, &req);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+    }
+    double t = (now() - t0) / OVL_CALIB_REPS;
+    free(scratch); free(counts);
+    return t;
+}
+
+void ovl_csr_loop(const csr_t *A, const ovl_split_t *s, exch_mode_t mode, halo_t *halo,
+                  double *x, const int *row_off, int iters, double *y, ovl_times_t *t) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+    int local_n = A->n, lo = row_off[my_rank];
+    int *counts = part_counts(row_off, comm_sz);
+    // allgather: οι interior γραμμές διαβάζουν το y_prev (τοπικός δείκτης = global - lo).
+    // halo: το x_loc έχει ήδη τοπικούς δείκτες και τα δικά μας στοιχεία εκτός recv buffer.
+    int int_off = mode == EXCH_HALO ? 0 : lo;
+    double *yp = y, *yc = (double*) malloc((local_n + 1) * sizeof(double));
+    MPI_Request req;
+    double t0, t1;
+    memset(t, 0, sizeof(*t));
+    if (iters <= 0) { free(yc); free(counts); return; }
+
+    // Επανάληψη 0: το x είναι ήδη πλήρες
+    spmv_rows(A, s->rows_int, s->n_int, x, 0, yp);
+    spmv_rows(A, s->rows_bnd, s->n_bnd, x, 0, yp);
+
+    for (int it = 1; it < iters; it++) {
+        exch_begin(mode, halo, yp, x, counts, row_off, &req);
+
+        t0 = now();
+        spmv_rows_progress(A, s->rows_int, s->n_int, mode == EXCH_HALO ? x : yp, int_off, yc, &req);
+        t1 = now();
+        t->interior += t1 - t0;
+
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+        t0 = now();
+        t->wait += t0 - t1;
+
+        spmv_rows(A, s->rows_bnd, s->n_bnd, x, 0, yc);
+        t->boundary += now() - t0;
+
+        double *tmp = yp; yp = yc; yc = tmp;
+    }
+
+    // Τελευταία ανανέωση του x (δεν υπάρχει υπολογισμός να την κρύψει)
+    t0 = now();
+    exch_begin(mode, halo, yp, x, counts, row_off, &req);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+    t->wait += now() - t0;
+    t->nexch = iters;
+    free(counts);
+
+    if (yp != y) { memcpy(y, yp, local_n * sizeof(double)); free(yp); }
+    else free(yc);
+}
+
+void ovl_dense_loop(const double *A, int n, double *x, const int *row_off, int iters,
+                    double *y, ovl_times_t *t) {
+    // Dense: κάθε γραμμή διαβάζει όλες τις στήλες, οπότε ο διαχωρισμός γίνεται
+    // στις στήλες: [lo, lo+local_n) από το y_prev πριν το Wait, οι υπόλοιπες μετά.
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+    int lo = row_off[my_rank], hi = row_off[my_rank + 1], local_n = hi - lo;
+    int *counts = part_counts(row_off, comm_sz);
+    double *yp = y, *yc = (double*) malloc((local_n + 1) * sizeof(double));
+    MPI_Request req;
+    double t0, t1;
+    memset(t, 0, sizeof(*t));
+    if (iters <= 0) { free(yc); free(counts); return; }
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < local_n; i++) {
+        double sum = 0.0;
+        for (int j = 0; j < n; j++) sum += A[(size_t) i * n + j] * x[j];
+        yp[i] = sum;
+    }
+
+    for (int it = 1; it < iters; it++) {
+        MPI_Iallgatherv(yp, local_n, MPI_DOUBLE, x, counts, row_off, MPI_DOUBLE, MPI_COMM_WORLD, &req);
+
+        t0 = now();
+        int flag = 0;
+        for (int c = 0; c < OVL_CHUNKS; c++) {
+            int i0 = (int) ((long long) c * local_n / OVL_CHUNKS);
+            int i1 = (int) ((long long) (c + 1) * local_n / OVL_CHUNKS);
+            #pragma omp parallel for schedule(static)
+            for (int i = i0; i < i1; i++) {
+                double sum = 0.0;
+                const double *Ai = A + (size_t) i * n;
+                for (int j = lo; j < hi; j++) sum += Ai[j] * yp[j - lo];
+                yc[i] = sum;
+            }
+            if (!flag) MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+        }
+        t1 = now();
+        t->interior += t1 - t0;
+
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+        t0 = now();
+        t->wait += t0 - t1;
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < local_n; i++) {
+            double sum = 0.0;
+            const double *Ai = A + (size_t) i * n;
+            for (int j = 0; j < lo; j++) sum += Ai[j] * x[j];
+            for (int j = hi; j < n; j++) sum += Ai[j] * x[j];
+            yc[i] += sum;
+        }
+        t->boundary += now() - t0;
+
+        double *tmp = yp; yp = yc; yc = tmp;
+    }
+
+    t0 = now();
+    MPI_Iallgatherv(yp, local_n, MPI_DOUBLE, x, counts, row_off, MPI_DOUBLE, MPI_COMM_WORLD, &req);
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+    t->wait += now() - t0;
+    t->nexch = iters;
+    free(counts);
+
+    if (yp != y) { memcpy(y, yp, local_n * sizeof(double)); free(yp); }
+    else free(yc);
+}
@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <mpi.h>
+#include "spmv.h"
+
+/* ======================================================
+   Διαμέριση γραμμών σε διεργασίες
+   ======================================================
+   - Ομοιόμορφη: n / P γραμμές, οι πρώτες n % P διεργασίες μία παραπάνω
+     (οποιοδήποτε n >= P).
+   - Ισορροπημένη ως προς nnz: τα όρια κόβονται πάνω στο prefix sum του
+     row_ptr, ώστε η διεργασία r να πάρει τις γραμμές με prefix(g) στο
+     [r * nnz / P, (r+1) * nnz / P) (στρογγυλεμένα στο πλησιέστερο όριο
+     γραμμής). Με κατανεμημένες γραμμές κάθε
+     διεργασία βρίσκει τα όρια που πέφτουν στις δικές της γραμμές και ένα
+     Allreduce(MIN) τα ενώνει (δεν συγκεντρώνεται ποτέ όλο το row_ptr).
+   Κάθε διεργασία κρατά τουλάχιστον μία γραμμή, και αν η ομοιόμορφη
+   διαμέριση έχει μικρότερο max nnz ανά διεργασία, κρατιέται εκείνη. */
+
+void part_uniform(int n, int P, int *row_off) {
+    for (int r = 0; r <= P; r++) row_off[r] = r * (n / P) + (r < n % P ? r : n % P);
+}
+
+int *part_counts(const int *row_off, int P) {
+    int *cnt = (int*) malloc(P * sizeof(int));
+    for (int r = 0; r < P; r++) cnt[r] = row_off[r + 1] - row_off[r];
+    return cnt;
+}
+
+void part_nnz(const csr_t *A, int lo, int n, int P, MPI_Comm comm, int *row_off) {
+    long long my_nnz = A->nnz, before = 0, total;
+    MPI_Exscan(&my_nnz, &before, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    MPI_Allreduce(&my_nnz, &total, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    int my_rank;
+    MPI_Comm_rank(comm, &my_rank);
+    if (my_rank == 0) before = 0;   // Το MPI_Exscan δεν ορίζει το αποτέλεσμα της διεργασίας 0
+
+    // Όριο r: η γραμμή g με prefix(g) πλησιέστερο στο r * total / P (n αν δεν είναι δική μας)
+    for (int r = 1; r < P; r++) {
+        long long target = total * r / P;
+        row_off[r] = n;
+        if (target < before || target > before + my_nnz) continue;
+        int a = 0, b = A->n;   // Δυαδική αναζήτηση: πρώτο i με row_ptr[i] >= target - before
+        while (a < b) {
+            int mid = (a + b) / 2;
+            if (before + A->row_ptr[mid] >= target) b = mid; else a = mid + 1;
+        }
+        // Το όριο πέφτει μέσα στη γραμμή a - 1: κρατάμε το πλησιέστερο άκρο της
+        if (a > 0 && target - (before + A->row_ptr[a - 1]) < before + A->row_ptr[a] - target) a--;
+        row_off[r] = lo + a;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, row_off + 1, P - 1, MPI_INT, MPI_MIN, comm);
+    row_off[0] = 0;
+    row_off[P] = n;
+
+    // Τουλάχιστον μία γραμμή ανά διεργασία
+    for (int r = 1; r < P; r++) if (row_off[r] < row_off[r - 1] + 1) row_off[r] = row_off[r - 1] + 1;
+    for (int r = P - 1; r > 0; r--) if (row_off[r] > row_off[r + 1] - 1) row_off[r] = row_off[r + 1] - 1;
+
+    // Με λίγες, "χοντρές" γραμμές η στρογγυλοποίηση μπορεί να βγει χειρότερη από
+    // την ομοιόμορφη: nnz ανά τμήμα και για τις δύο διαμερίσεις, κρατάμε την καλύτερη
+    int *uni = (int*) malloc((P + 1) * sizeof(int));
+    long long *cnt = (long long*) calloc(2 * P, sizeof(long long));
+    part_uniform(n, P, uni);
+    for (int i = 0, rb = 0, ru = 0; i < A->n; i++) {
+        int g = lo + i;
+        while (g >= row_off[rb + 1]) rb++;
+        while (g >= uni[ru + 1]) ru++;
+        cnt[rb] += A->row_ptr[i + 1] - A->row_ptr[i];
+        cnt[P + ru] += A->row_ptr[i + 1] - A->row_ptr[i];
+    }
+    MPI_Allreduce(MPI_IN_PLACE, cnt, 2 * P, MPI_LONG_LONG, MPI_SUM, comm);
+    long long max_b = 0, max_u = 0;
+    for (int r = 0; r < P; r++) {
+        if (cnt[r] > max_b) max_b = cnt[r];
+        if (cnt[P + r] > max_u) max_u = cnt[P + r];
+    }
+    if (max_u < max_b) for (int r = 0; r <= P; r++) row_off[r] = uni[r];
+    free(uni); free(cnt);
+}
+
+double part_imbalance(const int *row_ptr, const int *row_off, int P) {
+    double max = 0.0, sum = 0.0;
+    for (int r = 0; r < P; r++) {
+        double c = row_ptr[row_off[r + 1]] - row_ptr[row_off[r]];
+        if (c > max) max = c;
+        sum += c;
+    }
+    return sum > 0.0 ? max * P / sum : 1.0;
+}
+
+double part_imbalance_dist(const csr_t *A, MPI_Comm comm) {
+    int P;
+    MPI_Comm_size(comm, &P);
+    double c = A->nnz, max, sum;
+    MPI_Allreduce(&c, &max, 1, MPI_DOUBLE, MPI_MAX, comm);
+    MPI_Allreduce(&c, &sum, 1, MPI_DOUBLE, MPI_SUM, comm);
+    return sum > 0.0 ? max * P / sum : 1.0;
+}
+
+csr_t part_redistribute(const csr_t *A, int lo, const int *new_off, MPI_Comm comm) {
+    csr_ij_t *ij = (csr_ij_t*) malloc((A->nnz + 1) * sizeof(csr_ij_t));
+    for (int i = 0; i < A->n; i++)
+        for (int k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
+            ij[k].row = lo + i;
+            ij[k].col = A->col_ind[k];
+        }
+    csr_t B = csr_from_triplets(ij, A->values, A->nnz, new_off, comm);
+    free(ij);
+    return B;
+}
@@ -0,0 +1,274 @@
+/* File:     perf.h
+ *
+ * Purpose:  Προαιρετική ενοργάνωση των πυρήνων των ex3_1 / ex3_2 με μετρητές
+ *           υλικού (Linux perf_event_open) και ανάλυση roofline: cycles,
+ *           instructions και LLC misses ανά διεργασία (όλα τα νήματα, μόνο
+ *           user space), μαζί με τις πράξεις και τα εκτιμώμενα bytes του
+ *           πυρήνα, απέναντι σε ένα όριο εύρους ζώνης μετρημένο με STREAM triad.
+ *
+ * Χρήση:    perf_t pf;
+ *           perf_init(&pf, on);                  // Μετά το omp_set_num_threads
+ *           int r = perf_region(&pf, "csr");
+ *           perf_start(&pf, r);
+ *           ... πυρήνας ...
+ *           perf_stop(&pf, r, sec, flops, bytes);
+ *           perf_reset(&pf, r);                  // π.χ. μετά τις warm-up εκτελέσεις
+ *           perf_stream(&pf, MPI_COMM_WORLD);    // Συλλογική
+ *           perf_report(&pf, MPI_COMM_WORLD);    // Συλλογική, τυπώνει η διεργασία 0
+ *           perf_free(&pf);
+ *           Με on = 0 όλες οι κλήσεις είναι κενές.
+ *
+ * Μετρητές: ένα σύνολο ανά νήμα OpenMP (ανοίγει μέσα σε παράλληλη περιοχή με
+ *           pid = 0, άρα μετρά το ίδιο νήμα της ομάδας σε κάθε επόμενη
+ *           περιοχή) και αθροίζονται στο perf_stop. Με multiplexing οι τιμές
+ *           κλιμακώνονται με time_enabled / time_running. Αν ο πυρήνας δεν τους
+ *           παρέχει (VM, perf_event_paranoid) η αναφορά δίνει μόνο GFLOP/s / GB/s.
+ *
+ * Roofline: AI = flops / εκτιμώμενα bytes, οροφή μνήμης AI * B_stream.
+ *           Χαρακτηρισμός (ευρετικός): bandwidth αν η κίνηση (max των
+ *           εκτιμώμενων bytes και 64 B ανά LLC miss) φτάνει το 70% του STREAM
+ *           (cache αν το ξεπερνά: το working set χωρά στην cache), αλλιώς
+ *           compute αν IPC >= 1.5, αλλιώς latency.
+ *
+ * Ίδιο αντίγραφο στα ex3_1/ και ex3_2/ (όπως τα timer.h / bench.h): κάθε
+ * άσκηση χτίζεται αυτόνομα από τον δικό της κατάλογο και Makefile.
+ */
+#ifndef _PERF_H_
+#define _PERF_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <mpi.h>
+#include "timer.h"
+
+/* Χωρίς -fopenmp: ένα νήμα (ίδια stubs με τα poly.h / spmv.h) */
+#ifdef _OPENMP
+#include <omp.h>
+#elif !defined(_OMP_STUBS_)
+#define _OMP_STUBS_
+static inline int omp_get_thread_num(void) { return 0; }
+static inline int omp_get_num_threads(void) { return 1; }
+static inline int omp_get_max_threads(void) { return 1; }
+static inline void omp_set_num_threads(int n) { (void) n; }
+#endif
+
+#define PERF_NEV         3           // cycles, instructions, LLC misses
+#define PERF_MAX_REGIONS 4
+#define PERF_STREAM_N    (1 << 22)   // doubles ανά πίνακα του triad (32 MiB, > LLC)
+#define PERF_STREAM_REPS 5
+#define PERF_LINE        64          // bytes ανά LLC miss
+#define PERF_BW_BOUND    0.70        // Κλάσμα του STREAM πάνω από το οποίο -> bandwidth
+#define PERF_IPC_BOUND   1.5         // IPC πάνω από το οποίο -> compute
+
+typedef struct {
+    const char *name;
+    double cnt[PERF_NEV];   // Αθροισμένα σε όλα τα νήματα
+    double c0[PERF_NEV];    // Τιμές στο perf_start
+    double time, flops, bytes;
+} perf_region_t;
+
+typedef struct {
+    int on, hw, err;        // hw: μετρητές διαθέσιμοι, αλλιώς err = errno του perf_event_open
+    int nthr;
+    int *fd;                // fd[νήμα * PERF_NEV + γεγονός], -1 αν δεν άνοιξε
+    int nreg;
+    perf_region_t reg[PERF_MAX_REGIONS];
+    double stream_rank;     // GB/s του triad στη διεργασία (όλες τρέχουν ταυτόχρονα)
+    double stream_all;      // Άθροισμα όλων των διεργασιών
+} perf_t;
+
+static void perf_init(perf_t *p, int on) {
+    memset(p, 0, sizeof(*p));
+    p->on = on;
+    if (!on) return;
+    static const unsigned long long cfg[PERF_NEV] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES
+    };
+    p->nthr = omp_get_max_threads();
+    p->fd = (int*) malloc(p->nthr * PERF_NEV * sizeof(int));
+    for (int k = 0; k < p->nthr * PERF_NEV; k++) p->fd[k] = -1;
+
+    int err = 0;
+    #pragma omp parallel
+    {
+        int t = omp_get_thread_num();
+        for (int e = 0; e < PERF_NEV; e++) {
+            struct perf_event_attr a;
+            memset(&a, 0, sizeof(a));
+            a.size = sizeof(a);
+            a.type = PERF_TYPE_HARDWARE;
+            a.config = cfg[e];
+            a.exclude_kernel = 1;
+            a.exclude_hv = 1;
+            a.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int fd = (int) syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+            p->fd[t * PERF_NEV + e] = fd;
+            if (fd < 0) {
+                #pragma omp critical
+                err = errno;
+            }
+        }
+    }
+    p->hw = err == 0;
+    p->err = err;
+    if (!p->hw)
+        for (int k = 0; k < p->nthr * PERF_NEV; k++)
+            if (p->fd[k] >= 0) { close(p->fd[k]); p->fd[k] = -1; }
+}
+
+static int perf_region(perf_t *p, const char *name) {
+    if (!p->on || p->nreg == PERF_MAX_REGIONS) return -1;
+    p->reg[p->nreg].name = name;
+    return p->nreg++;
+}
+
+// Τρέχουσες (κλιμακωμένες) τιμές, αθροισμένες σε όλα τα νήματα
+static void perf_sample(const perf_t *p, double *c) {
+    for (int e = 0; e < PERF_NEV; e++) c[e] = 0.0;
+    if (!p->hw) return;
+    for (int t = 0; t < p->nthr; t++)
+        for (int e = 0; e < PERF_NEV; e++) {
+            unsigned long long v[3];   // value, time_enabled, time_running
+            int fd = p->fd[t * PERF_NEV + e];
+            if (fd < 0 || read(fd, v, sizeof(v)) != (ssize_t) sizeof(v) || v[2] == 0) continue;
+            c[e] += (double) v[0] * ((double) v[1] / v[2]);
+        }
+}
+
+static void perf_start(perf_t *p, int r) {
+    if (r < 0) return;
+    perf_sample(p, p->reg[r].c0);
+}
+
+// sec: χρόνος του πυρήνα, flops / bytes: πράξεις και εκτιμώμενη κίνηση μνήμης
+static void perf_stop(perf_t *p, int r, double sec, double flops, double bytes) {
+    if (r < 0) return;
+    perf_region_t *g = &p->reg[r];
+    double c[PERF_NEV];
+    perf_sample(p, c);
+    for (int e = 0; e < PERF_NEV; e++) g->cnt[e] += c[e] - g->c0[e];
+    g->time += sec;
+    g->flops += flops;
+    g->bytes += bytes;
+}
+
+static void perf_reset(perf_t *p, int r) {
+    if (r < 0) return;
+    perf_region_t *g = &p->reg[r];
+    memset(g->cnt, 0, sizeof(g->cnt));
+    g->time = g->flops = g->bytes = 0.0;
+}
+
+// STREAM triad a = b + s c σε όλες τις διεργασίες ταυτόχρονα (κοινό εύρος ζώνης
+// του κόμβου). Κρατάμε την καλύτερη από PERF_STREAM_REPS εκτελέσεις· το σύνολο
+// είναι P * bytes / (χρόνος της πιο αργής διεργασίας). Bytes: 3 x 8 ανά στοιχείο.
+static void perf_stream(perf_t *p, MPI_Comm comm) {
+    if (!p->on) return;
+    int comm_sz;
+    MPI_Comm_size(comm, &comm_sz);
+    long N = PERF_STREAM_N;
+    double *a = (double*) malloc(N * sizeof(double));
+    double *b = (double*) malloc(N * sizeof(double));
+    double *c = (double*) malloc(N * sizeof(double));
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < N; i++) { a[i] = 0.0; b[i] = 1.0; c[i] = 2.0; }
+
+    double best = 1e30, best_all = 1e30, t0, t1;
+    for (int rep = 0; rep < PERF_STREAM_REPS; rep++) {
+        MPI_Barrier(comm);
+        GET_TIME(t0);
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < N; i++) a[i] = b[i] + 3.0 * c[i];
+        GET_TIME(t1);
+        double dt = t1 - t0, dt_max;
+        MPI_Allreduce(&dt, &dt_max, 1, MPI_DOUBLE, MPI_MAX, comm);
+        if (dt < best) best = dt;
+        if (dt_max < best_all) best_all = dt_max;
+    }
+    double bytes = 3.0 * sizeof(double) * N;
+    p->stream_rank = bytes / best / 1e9;
+    p->stream_all = comm_sz * bytes / best_all / 1e9;
+    if (a[N / 2] != 7.0) p->stream_rank = 0.0;   // Ο έλεγχος κρατά τον βρόχο
+    free(a); free(b); free(c);
+}
+
+static void perf_fmt(char *buf, size_t len, const char *fmt, double v, int ok) {
+    if (ok) snprintf(buf, len, fmt, v);
+    else snprintf(buf, len, "n/a");
+}
+
+static void perf_row(const char *name, const char *who, const double *v, double stream, int hw) {
+    // v: time, cycles, instructions, LLC misses, flops, bytes
+    double t = v[0] > 0.0 ? v[0] : 1e-30;
+    double ipc = v[1] > 0.0 ? v[2] / v[1] : 0.0;
+    double est = v[5] / t / 1e9, miss = v[3] * PERF_LINE / t / 1e9;
+    double gf = v[4] / t / 1e9, ai = v[5] > 0.0 ? v[4] / v[5] : 0.0;
+    double traffic = hw && miss > est ? miss : est;
+    double frac = stream > 0.0 ? traffic / stream : 0.0;
+    const char *bound = frac > 1.0 ? "cache" : frac >= PERF_BW_BOUND ? "bandwidth" :
+                        !hw ? "-" : ipc >= PERF_IPC_BOUND ? "compute" : "latency";
+    char cyc[16], ip[16], llc[16], mgb[16];
+    perf_fmt(cyc, sizeof(cyc), "%.4f", v[1] / 1e9, hw);
+    perf_fmt(ip, sizeof(ip), "%.2f", ipc, hw);
+    perf_fmt(llc, sizeof(llc), "%.3e", v[3], hw);
+    perf_fmt(mgb, sizeof(mgb), "%.2f", miss, hw);
+    printf("%-8s %5s %12e %9s %6s %10s %9s %9.3f %9.3f %8.3f %9.2f %7.1f%% %10s\n", name, who, v[0],
+           cyc, ip, llc, mgb, est, gf, ai, ai * stream, 100.0 * frac, bound);
+}
+
+// Συλλογική. Η διεργασία 0 τυπώνει μία γραμμή ανά διεργασία και μία συνολική
+// (χρόνος: η πιο αργή διεργασία, μετρητές / πράξεις / bytes: άθροισμα) ανά περιοχή.
+// Περιοχές που δεν έτρεξαν σε καμία διεργασία παραλείπονται.
+static void perf_report(const perf_t *p, MPI_Comm comm) {
+    if (!p->on) return;
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    const int W = 7;   // time, cycles, instructions, LLC misses, flops, bytes, stream
+    double *all = my_rank == 0 ? (double*) malloc((size_t) comm_sz * W * sizeof(double)) : NULL;
+
+    if (my_rank == 0) {
+        printf("--- PERF (%s; STREAM triad %.2f GB/s for P=%d, %.2f GB/s on rank 0) ---\n",
+               p->hw ? "cycles, instructions, LLC misses: user space, all threads" : "hardware counters unavailable",
+               p->stream_all, comm_sz, p->stream_rank);
+        if (!p->hw) printf("perf_event_open: %s (check /proc/sys/kernel/perf_event_paranoid)\n", strerror(p->err));
+        printf("%-8s %5s %12s %9s %6s %10s %9s %9s %9s %8s %9s %8s %10s\n", "region", "rank", "time",
+               "Gcycles", "IPC", "LLC miss", "miss GB/s", "est GB/s", "GFLOP/s", "flop/B", "roof GF/s",
+               "STREAM", "bound");
+    }
+    for (int r = 0; r < p->nreg; r++) {
+        const perf_region_t *g = &p->reg[r];
+        double mine[7] = { g->time, g->cnt[0], g->cnt[1], g->cnt[2], g->flops, g->bytes, p->stream_rank };
+        double t_max;
+        MPI_Allreduce(&g->time, &t_max, 1, MPI_DOUBLE, MPI_MAX, comm);
+        if (t_max <= 0.0) continue;
+        MPI_Gather(mine, W, MPI_DOUBLE, all, W, MPI_DOUBLE, 0, comm);
+        if (my_rank != 0) continue;
+
+        double tot[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        for (int q = 0; q < comm_sz; q++) {
+            const double *v = all + (size_t) q * W;
+            char who[16];
+            snprintf(who, sizeof(who), "%d", q);
+            perf_row(g->name, who, v, v[6], p->hw);
+            if (v[0] > tot[0]) tot[0] = v[0];
+            for (int k = 1; k < 6; k++) tot[k] += v[k];
+        }
+        if (comm_sz > 1) perf_row(g->name, "all", tot, p->stream_all, p->hw);
+    }
+    free(all);
+}
+
+static void perf_free(perf_t *p) {
+    if (p->fd)
+        for (int k = 0; k < p->nthr * PERF_NEV; k++)
+            if (p->fd[k] >= 0) close(p->fd[k]);
+    free(p->fd);
+}
+
+#endif
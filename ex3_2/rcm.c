@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "spmv.h"
+#include "timer.h"
+
+/* ======================================================
+   Reverse Cuthill-McKee
+   ======================================================
+   Με τυχαίο μοτίβο στηλών κάθε γραμμή διαβάζει x από όλο το διάνυσμα: οι
+   προσβάσεις x[col_ind[j]] δεν έχουν τοπικότητα και κάθε διεργασία εξαρτάται
+   από όλες τις άλλες. Το RCM αριθμεί ξανά τους κόμβους του γράφου G(A + A^T)
+   κατά επίπεδα BFS (γείτονες με αύξουσα σειρά βαθμού) και αντιστρέφει τη
+   σειρά, ώστε τα μη-μηδενικά να συγκεντρώνονται κοντά στη διαγώνιο.
+
+   Ο αλγόριθμος είναι σειριακός (στον Master, O(nnz log d)): το μοτίβο
+   μαζεύεται με Gatherv, η μετάθεση μοιράζεται με Bcast και οι γραμμές
+   ανακατανέμονται με csr_from_triplets. */
+
+/* --- Μοτίβο του A + A^T στον Master (χωρίς διαγώνιο) --- */
+typedef struct {
+    int *ptr, *adj;    // Γειτνίαση σε μορφή CSR
+    int *deg;
+} graph_t;
+
+static void build_graph(graph_t *g, const int *row_len, const int *cols, int n) {
+    g->deg = (int*) calloc(n, sizeof(int));
+    g->ptr = (int*) malloc((n + 1) * sizeof(int));
+
+    // Κάθε a_ij (i != j) δίνει τις ακμές i -> j και j -> i (πιθανά διπλές,
+    // αν υπάρχει και το a_ji: δεν επηρεάζουν τη σειρά επίσκεψης)
+    size_t k = 0;
+    for (int i = 0; i < n; i++)
+        for (int e = 0; e < row_len[i]; e++, k++)
+            if (cols[k] != i) { g->deg[i]++; g->deg[cols[k]]++; }
+
+    g->ptr[0] = 0;
+    for (int i = 0; i < n; i++) g->ptr[i + 1] = g->ptr[i] + g->deg[i];
+    g->adj = (int*) malloc(((size_t) g->ptr[n] + 1) * sizeof(int));
+    int *fill = (int*) malloc(n * sizeof(int));
+    memcpy(fill, g->ptr, n * sizeof(int));
+    k = 0;
+    for (int i = 0; i < n; i++)
+        for (int e = 0; e < row_len[i]; e++, k++) {
+            int j = cols[k];
+            if (j == i) continue;
+            g->adj[fill[i]++] = j;
+            g->adj[fill[j]++] = i;
+        }
+    free(fill);
+}
+
+static void free_graph(graph_t *g) {
+    free(g->ptr); free(g->adj); free(g->deg);
+}
+
+// BFS από τον root: αριθμεί τα επίπεδα στο level[] και επιστρέφει το βάθος.
+// last: ο κόμβος ελάχιστου βαθμού στο τελευταίο επίπεδο.
+static int bfs_levels(const graph_t *g, int root, int *level, int *queue, int *last) {
+    int head = 0, tail = 0, depth = 0;
+    queue[tail++] = root;
+    level[root] = 0;
+    while (head < tail) {
+        int u = queue[head++];
+        for (int e = g->ptr[u]; e < g->ptr[u + 1]; e++) {
+            int v = g->adj[e];
+            if (level[v] < 0) {
+                level[v] = level[u] + 1;
+                if (level[v] > depth) depth = level[v];
+                queue[tail++] = v;
+            }
+        }
+    }
+    *last = -1;
+    for (int q = 0; q < tail; q++) {
+        int u = queue[q];
+        if (level[u] == depth && (*last < 0 || g->deg[u] < g->deg[*last])) *last = u;
+    }
+    for (int q = 0; q < tail; q++) level[queue[q]] = -1;   // Επαναφορά για το επόμενο BFS
+    return depth;
+}
+
+// Ψευδο-περιφερειακός κόμβος (George-Liu): επαναληπτικά BFS από τον κόμβο
+// ελάχιστου βαθμού του τελευταίου επιπέδου, όσο αυξάνεται η εκκεντρότητα
+static int pseudo_peripheral(const graph_t *g, int start, int *level, int *queue) {
+    int root = start, last;
+    int depth = bfs_levels(g, root, level, queue, &last);
+    for (int tries = 0; tries < 8; tries++) {
+        int cand_last;
+        int d = bfs_levels(g, last, level, queue, &cand_last);
+        if (d <= depth) break;
+        root = last;
+        depth = d;
+        last = cand_last;
+    }
+    return root;
+}
+
+static const int *sort_deg;   // Βαθμοί για το qsort των γειτόνων
+static int cmp_deg(const void *a, const void *b) {
+    int x = sort_deg[*(const int*) a], y = sort_deg[*(const int*) b];
+    if (x != y) return (x > y) - (x < y);
+    return (*(const int*) a > *(const int*) b) - (*(const int*) a < *(const int*) b);
+}
+
+// Cuthill-McKee για όλες τις συνεκτικές συνιστώσες, μετά αντιστροφή
+static void rcm_serial(const graph_t *g, int n, int *perm) {
+    int *level = (int*) malloc(n * sizeof(int));
+    int *queue = (int*) malloc(n * sizeof(int));
+    char *visited = (char*) calloc(n, 1);
+    for (int i = 0; i < n; i++) level[i] = -1;
+    sort_deg = g->deg;
+
+    // Κόμβοι κατά αύξοντα βαθμό: αφετηρίες των συνιστωσών
+    int *by_deg = (int*) malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) by_deg[i] = i;
+    qsort(by_deg, n, sizeof(int), cmp_deg);
+
+    int count = 0;
+    for (int s = 0; s < n; s++) {
+        if (visited[by_deg[s]]) continue;
+        int root = pseudo_peripheral(g, by_deg[s], level, queue);
+        int head = count;
+        perm[count++] = root;
+        visited[root] = 1;
+        while (head < count) {
+            int u = perm[head++];
+            int first = count;
+            for (int e = g->ptr[u]; e < g->ptr[u + 1]; e++) {
+                int v = g->adj[e];
+                if (!visited[v]) { visited[v] = 1; perm[count++] = v; }
+            }
+            qsort(perm + first, count - first, sizeof(int), cmp_deg);
+        }
+    }
+
+    for (int i = 0; i < n / 2; i++) {
+        int tmp = perm[i]; perm[i] = perm[n - 1 - i]; perm[n - 1 - i] = tmp;
+    }
+    free(level); free(queue); free(visited); free(by_deg);
+}
+
+int *rcm_order(const csr_t *local, const int *row_off, int n, MPI_Comm comm) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+
+    // Μήκη γραμμών και στήλες όλων των γραμμών στον Master
+    int *row_len = (int*) malloc(local->n * sizeof(int) + 1);
+    for (int i = 0; i < local->n; i++) row_len[i] = local->row_ptr[i + 1] - local->row_ptr[i];
+
+    int *all_len = NULL, *cols = NULL, *rcounts = NULL, *nnz_cnt = NULL, *nnz_off = NULL;
+    if (my_rank == 0) {
+        all_len = (int*) malloc(n * sizeof(int));
+        rcounts = (int*) malloc(comm_sz * sizeof(int));
+        nnz_cnt = (int*) malloc(comm_sz * sizeof(int));
+        nnz_off = (int*) malloc(comm_sz * sizeof(int));
+        for (int r = 0; r < comm_sz; r++) rcounts[r] = row_off[r + 1] - row_off[r];
+    }
+    MPI_Gatherv(row_len, local->n, MPI_INT, all_len, rcounts, row_off, MPI_INT, 0, comm);
+    MPI_Gather(&local->nnz, 1, MPI_INT, nnz_cnt, 1, MPI_INT, 0, comm);
+    if (my_rank == 0) {
+        size_t total = 0;
+        for (int r = 0; r < comm_sz; r++) { nnz_off[r] = (int) total; total += nnz_cnt[r]; }
+        cols = (int*) malloc((total + 1) * sizeof(int));
+    }
+    MPI_Gatherv(local->col_ind, local->nnz, MPI_INT, cols, nnz_cnt, nnz_off, MPI_INT, 0, comm);
+
+    int *perm = (int*) malloc(n * sizeof(int));
+    if (my_rank == 0) {
+        graph_t g;
+        build_graph(&g, all_len, cols, n);
+        rcm_serial(&g, n, perm);
+        free_graph(&g);
+    }
+    MPI_Bcast(perm, n, MPI_INT, 0, comm);
+
+    free(row_len); free(all_len); free(cols); free(rcounts); free(nnz_cnt); free(nnz_off);
+    return perm;
+}
+
+csr_t rcm_permute(const csr_t *local, const int *row_off, const int *perm, int n, MPI_Comm comm) {
+    int my_rank;
+    MPI_Comm_rank(comm, &my_rank);
+    int lo = row_off[my_rank];
+
+    // iperm[παλιός] = νέος: b_{iperm[i], iperm[j]} = a_ij
+    int *iperm = (int*) malloc(n * sizeof(int));
+    for (int k = 0; k < n; k++) iperm[perm[k]] = k;
+
+    csr_ij_t *ij = (csr_ij_t*) malloc((local->nnz + 1) * sizeof(csr_ij_t));
+    for (int i = 0; i < local->n; i++)
+        for (int j = local->row_ptr[i]; j < local->row_ptr[i + 1]; j++) {
+            ij[j].row = iperm[lo + i];
+            ij[j].col = iperm[local->col_ind[j]];
+        }
+    csr_t B = csr_from_triplets(ij, local->values, local->nnz, row_off, comm);
+    free(ij); free(iperm);
+    return B;
+}
+
+rcm_stats_t rcm_stats(const csr_t *local, int lo, MPI_Comm comm) {
+    long long bw = 0, prof = 0;
+    for (int i = 0; i < local->n; i++) {
+        long long g = lo + i, first = g;
+        for (int j = local->row_ptr[i]; j < local->row_ptr[i + 1]; j++) {
+            long long c = local->col_ind[j];
+            long long d = c > g ? c - g : g - c;
+            if (d > bw) bw = d;
+            if (c < first) first = c;
+        }
+        prof += g - first;
+    }
+    rcm_stats_t s;
+    MPI_Allreduce(&bw, &s.bandwidth, 1, MPI_LONG_LONG, MPI_MAX, comm);
+    MPI_Allreduce(&prof, &s.profile, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    return s;
+}
+
+static void csr_rows(const csr_t *A, const double *x, double *y) {
+    #pragma omp parallel for schedule(guided)
+    for (int i = 0; i < A->n; i++) {
+        double sum = 0.0;
+        for (int j = A->row_ptr[i]; j < A->row_ptr[i + 1]; j++) sum += A->values[j] * x[A->col_ind[j]];
+        y[i] = sum;
+    }
+}
+
+double rcm_probe(const csr_t *local, exch_mode_t mode, const int *row_off, int n,
+                 MPI_Comm comm, long long *ghosts) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    int lo = row_off[my_rank], local_n = local->n;
+    int *counts = part_counts(row_off, comm_sz);
+
+    // Το halo επαναριθμεί τις στήλες: δουλεύουμε σε αντίγραφο
+    csr_t A = *local;
+    A.col_ind = (int*) malloc((local->nnz + 1) * sizeof(int));
+    memcpy(A.col_ind, local->col_ind, local->nnz * sizeof(int));
+
+    double *x = (double*) malloc(n * sizeof(double));
+    double *y = (double*) malloc((local_n + 1) * sizeof(double));
+    for (int k = 0; k < n; k++) x[k] = 1.0;
+
+    halo_t halo;
+    double *xk = x;
+    long long my_ghosts = 0;
+    if (mode == EXCH_HALO) {
+        halo_setup(&halo, &A, row_off, comm);
+        xk = (double*) malloc((local_n + halo.nghost + 1) * sizeof(double));
+        halo_init_x(&halo, x, lo, xk);
+        my_ghosts = halo.nghost;
+    }
+    MPI_Allreduce(&my_ghosts, ghosts, 1, MPI_LONG_LONG, MPI_SUM, comm);
+
+    // 1 επανάληψη ζεσταίνει caches, μετά RCM_PROBE_ITERS χρονομετρημένες.
+    // Το x κανονικοποιείται ώστε να μη μεγαλώνει (ίδιο κόστος πράξεων).
+    double t0 = 0.0, t1;
+    for (int it = 0; it <= RCM_PROBE_ITERS; it++) {
+        if (it == 1) { MPI_Barrier(comm); GET_TIME(t0); }
+        csr_rows(&A, xk, y);
+        for (int i = 0; i < local_n; i++) y[i] *= 1e-3;
+        if (mode == EXCH_HALO) {
+            memcpy(xk, y, local_n * sizeof(double));
+            halo_exchange(&halo, xk);
+        } else {
+            MPI_Allgatherv(y, local_n, MPI_DOUBLE, x, counts, row_off, MPI_DOUBLE, comm);
+        }
+    }
+    MPI_Barrier(comm);
+    GET_TIME(t1);
+
+    if (mode == EXCH_HALO) { halo_free(&halo); free(xk); }
+    free(A.col_ind); free(x); free(y); free(counts);
+    return (t1 - t0) / RCM_PROBE_ITERS;
+}
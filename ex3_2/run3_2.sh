@@ -52,8 +52,8 @@ for n in $SIZES; do
             echo "   [Sparsity: $sp | Iterations: $iters]" >> $OUTPUT_FILE
             
             for p in $PROCESSES; do
-                # Έλεγχος συμβατότητας N και P
-                if (( n % p != 0 )); then
+                # Τουλάχιστον μία γραμμή ανά διεργασία
+                if (( n < p )); then
                     continue
                 fi
 
@@ -0,0 +1,74 @@
+#!/bin/bash
+
+# --- Hybrid MPI + OpenMP Πειράματα ---
+# Ίδιος συνολικός αριθμός πυρήνων (4 ανά κόμβο), διαφορετικός συνδυασμός
+# διεργασιών ανά κόμβο (RPN) x νημάτων ανά διεργασία (T):
+#   4x1 (καθαρό MPI), 2x2, 1x4 (μία διεργασία ανά κόμβο)
+
+SIZES="10240"
+SPARSITIES="0.00 0.99"
+ITER_COUNTS="20"
+NODES="1 2 4 8"
+LAYOUTS="4x1 2x2 1x4"
+
+OUTPUT_FILE="results_hybrid_report.txt"
+MACHINES_FILE="machines"
+
+# --- Build ---
+echo "--- Compiling Project ---"
+make clean
+make
+
+if [ ! -f ./ex3_2 ]; then
+    echo "❌ Error: Compilation failed!"
+    exit 1
+fi
+
+# --- Output Initialization ---
+echo "==================================================================" > $OUTPUT_FILE
+echo " HYBRID (MPI x OpenMP) EXPERIMENTS (Ex 3.2)" >> $OUTPUT_FILE
+echo " Sizes: $SIZES | Nodes: $NODES | Layouts (RPN x T): $LAYOUTS" >> $OUTPUT_FILE
+echo " Date: $(date)" >> $OUTPUT_FILE
+echo "==================================================================" >> $OUTPUT_FILE
+echo "" >> $OUTPUT_FILE
+
+# --- Execution Loops ---
+echo "🚀 Starting Experiments..."
+
+for n in $SIZES; do
+    echo "------------------------------------------------------------------" >> $OUTPUT_FILE
+    echo ">>> MATRIX SIZE N = $n <<<" >> $OUTPUT_FILE
+    echo "------------------------------------------------------------------" >> $OUTPUT_FILE
+
+    for sp in $SPARSITIES; do
+        for iters in $ITER_COUNTS; do
+
+            echo "" >> $OUTPUT_FILE
+            echo "   [Sparsity: $sp | Iterations: $iters]" >> $OUTPUT_FILE
+
+            for nodes in $NODES; do
+                for layout in $LAYOUTS; do
+                    rpn=${layout%x*}
+                    t=${layout#*x}
+                    p=$((nodes * rpn))
+
+                    # Τουλάχιστον μία γραμμή ανά διεργασία
+                    if (( n < p )); then
+                        continue
+                    fi
+
+                    echo "   Running: N=$n | Sparsity=$sp | Nodes=$nodes | RPN=$rpn | T=$t"
+                    echo "   --- Nodes=$nodes | P=$p (RPN=$rpn) | T=$t ---" >> $OUTPUT_FILE
+
+                    OMP_NUM_THREADS=$t OMP_PROC_BIND=close \
+                        mpiexec -f $MACHINES_FILE -ppn $rpn -n $p ./ex3_2 -t $t $n $sp $iters >> $OUTPUT_FILE
+
+                    echo "   ---------------------" >> $OUTPUT_FILE
+                done
+            done
+        done
+    done
+done
+
+echo "✅ All experiments finished!"
+echo "📄 Results saved in: $OUTPUT_FILE"
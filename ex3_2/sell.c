@@ -0,0 +1,207 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+#include <mpi.h>
+#include "spmv.h"
+
+/* ======================================================
+   SELL-C-σ (Sliced ELLPACK με ταξινόμηση)
+   ======================================================
+   Οι γραμμές ομαδοποιούνται σε chunks των C = SELL_C γραμμών. Μέσα σε κάθε
+   chunk τα στοιχεία αποθηκεύονται κατά στήλη (column-major): το j-οστό
+   στοιχείο των C γραμμών είναι διαδοχικό, άρα ένα διάνυσμα SIMD επεξεργάζεται
+   C γραμμές ταυτόχρονα. Οι κοντύτερες γραμμές συμπληρώνονται (padding) ως το
+   μήκος της μεγαλύτερης του chunk. Για να μειωθεί το padding, οι γραμμές
+   ταξινομούνται κατά φθίνον μήκος μέσα σε παράθυρα σ γραμμών και το
+   αποτέλεσμα γράφεται στη θέση perm[] της αρχικής γραμμής.
+   Ο διαχωρισμός στηλών (global ή halo) δεν αλλάζει: διαβάζουμε x[col]. */
+
+typedef struct { int len, row; } row_len_t;
+
+static int cmp_len_desc(const void *a, const void *b) {
+    const row_len_t *x = (const row_len_t*) a, *y = (const row_len_t*) b;
+    if (x->len != y->len) return y->len - x->len;
+    return x->row - y->row;   // Σταθερή σειρά για ίσα μήκη
+}
+
+// Ταξινόμηση των γραμμών σε παράθυρα sigma (perm[i] = αρχική γραμμή της θέσης i)
+static row_len_t *sorted_rows(const csr_t *A, int sigma) {
+    row_len_t *r = (row_len_t*) malloc((A->n + 1) * sizeof(row_len_t));
+    for (int i = 0; i < A->n; i++) {
+        r[i].len = A->row_ptr[i + 1] - A->row_ptr[i];
+        r[i].row = i;
+    }
+    for (int w = 0; w < A->n; w += sigma) {
+        int cnt = w + sigma < A->n ? sigma : A->n - w;
+        qsort(r + w, cnt, sizeof(row_len_t), cmp_len_desc);
+    }
+    return r;
+}
+
+sell_t csr2sell(const csr_t *A, int sigma) {
+    sell_t S;
+    S.n = A->n;
+    S.sigma = sigma;
+    S.nnz = A->nnz;
+    S.nchunks = (A->n + SELL_C - 1) / SELL_C;
+    S.chunk_ptr = (int*) malloc((S.nchunks + 1) * sizeof(int));
+    S.chunk_len = (int*) malloc((S.nchunks + 1) * sizeof(int));
+    S.perm = (int*) malloc(S.nchunks * SELL_C * sizeof(int));
+
+    row_len_t *r = sorted_rows(A, sigma);
+
+    // Μήκος κάθε chunk = η μεγαλύτερη γραμμή του
+    S.chunk_ptr[0] = 0;
+    for (int c = 0; c < S.nchunks; c++) {
+        int len = 0;
+        for (int l = 0; l < SELL_C; l++) {
+            int i = c * SELL_C + l;
+            S.perm[i] = i < A->n ? r[i].row : -1;   // -1: γραμμή-συμπλήρωμα
+            if (i < A->n && r[i].len > len) len = r[i].len;
+        }
+        S.chunk_len[c] = len;
+        S.chunk_ptr[c + 1] = S.chunk_ptr[c] + len * SELL_C;
+    }
+    S.nnz_stored = S.chunk_ptr[S.nchunks];
+
+    S.values = (double*) malloc((S.nnz_stored + 1) * sizeof(double));
+    S.col_ind = (int*) malloc((S.nnz_stored + 1) * sizeof(int));
+
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < S.nchunks; c++) {
+        for (int l = 0; l < SELL_C; l++) {
+            int row = S.perm[c * SELL_C + l];
+            int start = row >= 0 ? A->row_ptr[row] : 0;
+            int len = row >= 0 ? A->row_ptr[row + 1] - start : 0;
+            // Padding: τιμή 0 σε έγκυρη στήλη (η τελευταία της γραμμής ή 0)
+            int pad_col = len > 0 ? A->col_ind[start + len - 1] : 0;
+            for (int j = 0; j < S.chunk_len[c]; j++) {
+                int k = S.chunk_ptr[c] + j * SELL_C + l;
+                S.values[k] = j < len ? A->values[start + j] : 0.0;
+                S.col_ind[k] = j < len ? A->col_ind[start + j] : pad_col;
+            }
+        }
+    }
+    free(r);
+    return S;
+}
+
+void free_sell(sell_t *S) {
+    free(S->chunk_ptr); free(S->chunk_len); free(S->perm);
+    free(S->values); free(S->col_ind);
+}
+
+/* --- Πυρήνες: ένα chunk (SELL_C = 8 γραμμές) ανά κλήση --- */
+
+static void chunk_scalar(const sell_t *S, int c, const double *x, double *out) {
+    double acc[SELL_C] = { 0.0 };
+    const double *v = S->values + S->chunk_ptr[c];
+    const int *col = S->col_ind + S->chunk_ptr[c];
+    for (int j = 0; j < S->chunk_len[c]; j++)
+        for (int l = 0; l < SELL_C; l++)
+            acc[l] += v[j * SELL_C + l] * x[col[j * SELL_C + l]];
+    for (int l = 0; l < SELL_C; l++) out[l] = acc[l];
+}
+
+/* AVX2: 2 x 4 γραμμές, gather του x */
+__attribute__((target("avx2,fma")))
+static void chunk_avx2(const sell_t *S, int c, const double *x, double *out) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    const double *v = S->values + S->chunk_ptr[c];
+    const int *col = S->col_ind + S->chunk_ptr[c];
+    for (int j = 0; j < S->chunk_len[c]; j++) {
+        __m128i i0 = _mm_loadu_si128((const __m128i*) (col + j * SELL_C));
+        __m128i i1 = _mm_loadu_si128((const __m128i*) (col + j * SELL_C + 4));
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(v + j * SELL_C), _mm256_i32gather_pd(x, i0, 8), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(v + j * SELL_C + 4), _mm256_i32gather_pd(x, i1, 8), acc1);
+    }
+    _mm256_storeu_pd(out, acc0);
+    _mm256_storeu_pd(out + 4, acc1);
+}
+
+/* AVX-512: 8 γραμμές σε έναν καταχωρητή */
+__attribute__((target("avx512f")))
+static void chunk_avx512(const sell_t *S, int c, const double *x, double *out) {
+    __m512d acc = _mm512_setzero_pd();
+    const double *v = S->values + S->chunk_ptr[c];
+    const int *col = S->col_ind + S->chunk_ptr[c];
+    for (int j = 0; j < S->chunk_len[c]; j++) {
+        __m256i idx = _mm256_loadu_si256((const __m256i*) (col + j * SELL_C));
+        acc = _mm512_fmadd_pd(_mm512_loadu_pd(v + j * SELL_C), _mm512_i32gather_pd(idx, x, 8), acc);
+    }
+    _mm512_storeu_pd(out, acc);
+}
+
+typedef void (*sell_chunk_fn)(const sell_t *S, int c, const double *x, double *out);
+
+const char *sell_isa_name(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return "avx512";
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return "avx2";
+    return "scalar";
+}
+
+void sell_spmv(const sell_t *S, const double *x, double *y) {
+    sell_chunk_fn chunk = chunk_scalar;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) chunk = chunk_avx512;
+    else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) chunk = chunk_avx2;
+
+    #pragma omp parallel for schedule(guided)
+    for (int c = 0; c < S->nchunks; c++) {
+        double out[SELL_C];
+        chunk(S, c, x, out);
+        for (int l = 0; l < SELL_C; l++) {
+            int row = S->perm[c * SELL_C + l];
+            if (row >= 0) y[row] = out[l];
+        }
+    }
+}
+
+/* ======================================================
+   Επιλογή μορφής (CSR / SELL / dense)
+   ======================================================
+   - dense:  αν η πυκνότητα ξεπερνά το FMT_DENSE_MIN. Το CSR διαβάζει 12 bytes
+             ανά μη-μηδενικό (τιμή + στήλη), το dense 8 bytes ανά στοιχείο,
+             άρα πάνω από 2/3 πυκνότητα το dense μεταφέρει λιγότερα δεδομένα
+             (και ο πυρήνας του διανυσματοποιείται χωρίς gather).
+   - SELL:   αν το padding μένει μικρό (πληρότητα nnz / stored >= SELL_MIN_FILL,
+             όπου η διασπορά των μηκών γραμμών το καθορίζει) και υπάρχει
+             αρκετή δουλειά ανά γραμμή (μέσο μήκος >= SELL_MIN_ROW).
+   - CSR:    διαφορετικά (πολύ άνισες ή σχεδόν άδειες γραμμές).
+   Τα στατιστικά είναι global (Allreduce), άρα η απόφαση είναι κοινή. */
+
+fmt_t fmt_select(const csr_t *A, int n, int sigma, MPI_Comm comm, fmt_stats_t *st) {
+    double loc[4] = { 0.0, 0.0, 0.0, 0.0 };   // nnz, Σ len^2, stored (SELL), γραμμές
+    row_len_t *r = sorted_rows(A, sigma);
+    for (int i = 0; i < A->n; i++) {
+        double len = r[i].len;
+        loc[0] += len;
+        loc[1] += len * len;
+    }
+    for (int i = 0; i < A->n; i += SELL_C) loc[2] += (double) r[i].len * SELL_C;   // Ταξινομημένο: η πρώτη είναι η μεγαλύτερη
+    loc[3] = A->n;
+    free(r);
+
+    double glob[4];
+    MPI_Allreduce(loc, glob, 4, MPI_DOUBLE, MPI_SUM, comm);
+
+    st->mean = glob[0] / glob[3];
+    st->cv = st->mean > 0.0 ? sqrt(fmax(glob[1] / glob[3] - st->mean * st->mean, 0.0)) / st->mean : 0.0;
+    st->density = glob[0] / ((double) n * n);
+    st->fill = glob[2] > 0.0 ? glob[0] / glob[2] : 1.0;
+
+    if (st->density >= FMT_DENSE_MIN) return FMT_DENSE;
+    if (st->fill >= SELL_MIN_FILL && st->mean >= SELL_MIN_ROW) return FMT_SELL;
+    return FMT_CSR;
+}
+
+const char *fmt_name(fmt_t f) {
+    switch (f) {
+        case FMT_SELL:  return "sell";
+        case FMT_DENSE: return "dense";
+        case FMT_AUTO:  return "auto";
+        default:        return "csr";
+    }
+}
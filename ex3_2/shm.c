@@ -0,0 +1,148 @@
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "spmv.h"
+
+/* ======================================================
+   Κοινόχρηστο x ανά κόμβο (MPI-3 shared windows)
+   ======================================================
+   Με το αρχικό Allgather κάθε διεργασία κρατά όλο το x (P αντίγραφα ανά
+   κόμβο) και σε κάθε επανάληψη ξαναγεμίζονται όλα. Εδώ:
+   - Κάθε κόμβος έχει ΔΥΟ κοινόχρηστα διανύσματα n στοιχείων (τρέχον και
+     επόμενο x), ώστε οι εγγραφές του νέου x να μη συγκρούονται με
+     αναγνώσεις του τρέχοντος από πιο αργές διεργασίες του κόμβου.
+   - Κάθε διεργασία γράφει το local_y της στο επόμενο x του κόμβου της.
+   - Μόνο οι leaders (node rank 0) ανταλλάσσουν τα τμήματα των κόμβων τους
+     με MPI_Allgatherv: η inter-node κίνηση πέφτει κατά τον παράγοντα
+     ranks-per-node.
+   Οι διεργασίες ενός κόμβου δεν είναι απαραίτητα διαδοχικές στο
+   MPI_COMM_WORLD, οπότε τα τμήματα κάθε κόμβου πακετάρονται/ξεπακετάρονται. */
+
+// Ορατότητα των εγγραφών στο κοινό παράθυρο σε όλο τον κόμβο
+static void node_sync(shm_vec_t *v) {
+    MPI_Win_sync(v->win);
+    MPI_Barrier(v->node);
+    MPI_Win_sync(v->win);
+}
+
+void shm_vec_create(shm_vec_t *v, int n, const int *row_off) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &comm_sz);
+
+    v->n = n;
+    v->cur = 0;
+    v->row_off = row_off;
+    v->counts = v->displs = v->order = v->node_first = NULL;
+    v->pack = v->recv = NULL;
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, my_rank, MPI_INFO_NULL, &v->node);
+    MPI_Comm_rank(v->node, &v->node_rank);
+    MPI_Comm_size(v->node, &v->node_size);
+    // Ο world rank 0 είναι leader με leader rank 0 (ρίζα του αρχικού Bcast)
+    MPI_Comm_split(MPI_COMM_WORLD, v->node_rank == 0 ? 0 : MPI_UNDEFINED, my_rank, &v->leaders);
+
+    // Ο leader δεσμεύει 2n στοιχεία, οι υπόλοιποι 0 και παίρνουν τη διεύθυνσή του
+    double *base;
+    MPI_Aint size = v->node_rank == 0 ? (MPI_Aint) 2 * n * sizeof(double) : 0;
+    MPI_Win_allocate_shared(size, sizeof(double), MPI_INFO_NULL, v->node, &base, &v->win);
+    if (v->node_rank != 0) {
+        MPI_Aint qsize;
+        int disp;
+        MPI_Win_shared_query(v->win, 0, &qsize, &disp, &base);
+    }
+    v->buf[0] = base;
+    v->buf[1] = base + n;
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, v->win);
+
+    // Σε ποιον κόμβο (leader rank) ανήκει κάθε world rank
+    int node_id = 0;
+    if (v->leaders != MPI_COMM_NULL) {
+        MPI_Comm_rank(v->leaders, &node_id);
+        MPI_Comm_size(v->leaders, &v->nnodes);
+    }
+    MPI_Bcast(&node_id, 1, MPI_INT, 0, v->node);
+    MPI_Bcast(&v->nnodes, 1, MPI_INT, 0, v->node);
+    int *node_of = (int*) malloc(comm_sz * sizeof(int));
+    MPI_Allgather(&node_id, 1, MPI_INT, node_of, 1, MPI_INT, MPI_COMM_WORLD);
+
+    if (v->leaders != MPI_COMM_NULL) {
+        // Packed σειρά: κόμβος 0 (τα ranks του με αύξουσα σειρά), κόμβος 1, ...
+        v->counts = (int*) calloc(v->nnodes, sizeof(int));
+        v->displs = (int*) malloc(v->nnodes * sizeof(int));
+        v->order = (int*) malloc(comm_sz * sizeof(int));
+        v->node_first = (int*) malloc((v->nnodes + 1) * sizeof(int));
+        int k = 0;
+        for (int d = 0; d < v->nnodes; d++) {
+            v->node_first[d] = k;
+            for (int r = 0; r < comm_sz; r++) if (node_of[r] == d) {
+                v->order[k++] = r;
+                v->counts[d] += row_off[r + 1] - row_off[r];
+            }
+            v->displs[d] = d > 0 ? v->displs[d - 1] + v->counts[d - 1] : 0;
+        }
+        v->node_first[v->nnodes] = k;
+        v->pack = (double*) malloc((v->counts[node_id] + 1) * sizeof(double));
+        v->recv = (double*) malloc(n * sizeof(double));
+    }
+    free(node_of);
+}
+
+void shm_vec_bcast(shm_vec_t *v, const double *x_root) {
+    int my_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    double *x = shm_vec_x(v);
+    if (v->leaders != MPI_COMM_NULL) {
+        if (my_rank == 0) memcpy(x, x_root, v->n * sizeof(double));
+        MPI_Bcast(x, v->n, MPI_DOUBLE, 0, v->leaders);
+    }
+    node_sync(v);
+}
+
+void shm_vec_exchange(shm_vec_t *v, const double *local_y) {
+    int my_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+    double *next = v->buf[1 - v->cur];
+
+    // 1. Κάθε διεργασία γράφει το τμήμα της στο επόμενο x του κόμβου
+    int lo = v->row_off[my_rank];
+    memcpy(next + lo, local_y, (v->row_off[my_rank + 1] - lo) * sizeof(double));
+    node_sync(v);
+
+    // 2. Inter-node ανταλλαγή μόνο μεταξύ leaders
+    if (v->leaders != MPI_COMM_NULL && v->nnodes > 1) {
+        int node_id;
+        MPI_Comm_rank(v->leaders, &node_id);
+
+        // Πακετάρισμα των τμημάτων του κόμβου
+        int pos = 0;
+        for (int m = v->node_first[node_id]; m < v->node_first[node_id + 1]; m++) {
+            int r = v->order[m], len = v->row_off[r + 1] - v->row_off[r];
+            memcpy(v->pack + pos, next + v->row_off[r], len * sizeof(double));
+            pos += len;
+        }
+
+        MPI_Allgatherv(v->pack, v->counts[node_id], MPI_DOUBLE,
+                       v->recv, v->counts, v->displs, MPI_DOUBLE, v->leaders);
+
+        // Ξεπακετάρισμα των τμημάτων των άλλων κόμβων
+        pos = 0;
+        for (int m = 0; m < v->node_first[v->nnodes]; m++) {
+            int r = v->order[m], len = v->row_off[r + 1] - v->row_off[r];
+            if (m < v->node_first[node_id] || m >= v->node_first[node_id + 1])
+                memcpy(next + v->row_off[r], v->recv + pos, len * sizeof(double));
+            pos += len;
+        }
+    }
+    node_sync(v);
+    v->cur = 1 - v->cur;
+}
+
+void shm_vec_free(shm_vec_t *v) {
+    MPI_Win_unlock_all(v->win);
+    MPI_Win_free(&v->win);
+    if (v->leaders != MPI_COMM_NULL) MPI_Comm_free(&v->leaders);
+    MPI_Comm_free(&v->node);
+    free(v->counts); free(v->displs); free(v->order); free(v->node_first);
+    free(v->pack); free(v->recv);
+}
@@ -0,0 +1,178 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+#include <mpi.h>
+#include "spmv.h"
+#include "timer.h"
+
+/* ======================================================
+   SpMM: Y = A X με k διανύσματα ταυτόχρονα
+   ======================================================
+   Το SpMV διαβάζει 12 bytes (τιμή + στήλη) για 2 πράξεις ανά μη-μηδενικό,
+   άρα περιορίζεται από το εύρος ζώνης της μνήμης. Με k διανύσματα κάθε
+   a_ij διαβάζεται μία φορά και χρησιμοποιείται k φορές: το X είναι
+   row-major (X[c * k + l] = l-οστό διάνυσμα, στήλη c), οπότε η γραμμή c
+   του X είναι συνεχής και φορτώνεται με διανυσματικές εντολές. Το SIMD
+   γίνεται κατά μήκος των k διανυσμάτων (όχι των γραμμών, όπως στο SELL)
+   και δεν χρειάζεται gather.
+
+   Ανανέωση του X: ΜΙΑ συλλογική κλήση ανά επανάληψη για όλα τα k
+   διανύσματα, με datatype k συνεχόμενων doubles (τα counts / displs του
+   Allgatherv και του halo μένουν σε γραμμές). */
+
+#define SPMM_BLOCK 32   // Διανύσματα ανά πέρασμα της γραμμής (4 καταχωρητές AVX-512)
+
+typedef void (*spmm_row_fn)(const double *v, const int *col, int len, const double *X, int k, double *y);
+
+/* --- Scalar --- */
+static void row_scalar(const double *v, const int *col, int len, const double *X, int k, double *y) {
+    for (int l0 = 0; l0 < k; l0 += SPMM_BLOCK) {
+        int w = k - l0 < SPMM_BLOCK ? k - l0 : SPMM_BLOCK;
+        double acc[SPMM_BLOCK] = { 0.0 };
+        for (int j = 0; j < len; j++) {
+            const double *xr = X + (size_t) col[j] * k + l0;
+            for (int l = 0; l < w; l++) acc[l] += v[j] * xr[l];
+        }
+        for (int l = 0; l < w; l++) y[l0 + l] = acc[l];
+    }
+}
+
+/* --- AVX2: 4 καταχωρητές x 4 διανύσματα, maskload για την ουρά --- */
+__attribute__((target("avx2,fma")))
+static __m256i mask_avx2(int rem) {
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(rem), _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+__attribute__((target("avx2,fma")))
+static void row_avx2(const double *v, const int *col, int len, const double *X, int k, double *y) {
+    for (int l0 = 0; l0 < k; l0 += 16) {
+        int rem = k - l0;
+        int nreg = rem >= 16 ? 4 : (rem + 3) / 4;
+        __m256i m0 = mask_avx2(rem), m1 = mask_avx2(rem - 4), m2 = mask_avx2(rem - 8), m3 = mask_avx2(rem - 12);
+        __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+        __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+        for (int j = 0; j < len; j++) {
+            const double *xr = X + (size_t) col[j] * k + l0;
+            __m256d a = _mm256_set1_pd(v[j]);
+            acc0 = _mm256_fmadd_pd(a, _mm256_maskload_pd(xr, m0), acc0);
+            if (nreg > 1) acc1 = _mm256_fmadd_pd(a, _mm256_maskload_pd(xr + 4, m1), acc1);
+            if (nreg > 2) acc2 = _mm256_fmadd_pd(a, _mm256_maskload_pd(xr + 8, m2), acc2);
+            if (nreg > 3) acc3 = _mm256_fmadd_pd(a, _mm256_maskload_pd(xr + 12, m3), acc3);
+        }
+        _mm256_maskstore_pd(y + l0, m0, acc0);
+        if (nreg > 1) _mm256_maskstore_pd(y + l0 + 4, m1, acc1);
+        if (nreg > 2) _mm256_maskstore_pd(y + l0 + 8, m2, acc2);
+        if (nreg > 3) _mm256_maskstore_pd(y + l0 + 12, m3, acc3);
+    }
+}
+
+/* --- AVX-512: 4 καταχωρητές x 8 διανύσματα, masked φορτώσεις για την ουρά --- */
+static __mmask8 mask_avx512(int rem) {
+    return rem >= 8 ? 0xFF : rem <= 0 ? 0 : (__mmask8) ((1u << rem) - 1);
+}
+
+__attribute__((target("avx512f")))
+static void row_avx512(const double *v, const int *col, int len, const double *X, int k, double *y) {
+    for (int l0 = 0; l0 < k; l0 += SPMM_BLOCK) {
+        int rem = k - l0;
+        int nreg = rem >= SPMM_BLOCK ? 4 : (rem + 7) / 8;
+        __mmask8 m0 = mask_avx512(rem), m1 = mask_avx512(rem - 8);
+        __mmask8 m2 = mask_avx512(rem - 16), m3 = mask_avx512(rem - 24);
+        __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+        __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+        for (int j = 0; j < len; j++) {
+            const double *xr = X + (size_t) col[j] * k + l0;
+            __m512d a = _mm512_set1_pd(v[j]);
+            acc0 = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(m0, xr), acc0);
+            if (nreg > 1) acc1 = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(m1, xr + 8), acc1);
+            if (nreg > 2) acc2 = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(m2, xr + 16), acc2);
+            if (nreg > 3) acc3 = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(m3, xr + 24), acc3);
+        }
+        _mm512_mask_storeu_pd(y + l0, m0, acc0);
+        if (nreg > 1) _mm512_mask_storeu_pd(y + l0 + 8, m1, acc1);
+        if (nreg > 2) _mm512_mask_storeu_pd(y + l0 + 16, m2, acc2);
+        if (nreg > 3) _mm512_mask_storeu_pd(y + l0 + 24, m3, acc3);
+    }
+}
+
+const char *spmm_isa_name(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return "avx512";
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return "avx2";
+    return "scalar";
+}
+
+void spmm_csr(const csr_t *A, const double *X, int k, double *Y) {
+    spmm_row_fn row = row_scalar;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) row = row_avx512;
+    else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) row = row_avx2;
+
+    #pragma omp parallel for schedule(guided)
+    for (int i = 0; i < A->n; i++) {
+        int start = A->row_ptr[i];
+        row(A->values + start, A->col_ind + start, A->row_ptr[i + 1] - start, X, k, Y + (size_t) i * k);
+    }
+}
+
+void spmm_run(const csr_t *A, exch_mode_t mode, halo_t *halo, const int *row_off, int k, int iters,
+              const double *x0, const double *y_ref, MPI_Comm comm, spmm_result_t *res) {
+    int my_rank, comm_sz;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &comm_sz);
+    int m = A->n, n = row_off[comm_sz], lo = row_off[my_rank];
+    int ncols = mode == EXCH_HALO ? m + halo->nghost : n;
+
+    double *X = (double*) malloc(((size_t) ncols * k + 1) * sizeof(double));
+    double *Y = (double*) malloc(((size_t) m * k + 1) * sizeof(double));
+
+    // X0[:, l] = (l + 1) x0: διαφορετικά διανύσματα με γνωστό αποτέλεσμα (l + 1) A^iters x0
+    for (int c = 0; c < ncols; c++) {
+        int g = mode == EXCH_HALO ? (c < m ? lo + c : halo->ghost_cols[c - m]) : c;
+        for (int l = 0; l < k; l++) X[(size_t) c * k + l] = (l + 1) * x0[g];
+    }
+
+    // Allgatherv σε μονάδες γραμμών του X (k doubles)
+    MPI_Datatype blk;
+    MPI_Type_contiguous(k, MPI_DOUBLE, &blk);
+    MPI_Type_commit(&blk);
+    int *counts = (int*) malloc(comm_sz * sizeof(int));
+    for (int r = 0; r < comm_sz; r++) counts[r] = row_off[r + 1] - row_off[r];
+
+    double t0, t1, t_k0, t_k1;
+    res->k = k;
+    res->work = 0.0;
+    MPI_Barrier(comm);
+    GET_TIME(t0);
+    for (int iter = 0; iter < iters; iter++) {
+        GET_TIME(t_k0);
+        spmm_csr(A, X, k, Y);
+        GET_TIME(t_k1);
+        res->work += t_k1 - t_k0;
+        if (mode == EXCH_HALO) {
+            memcpy(X, Y, (size_t) m * k * sizeof(double));
+            halo_exchange_block(halo, X, k);
+        } else {
+            MPI_Allgatherv(Y, m, blk, X, counts, row_off, blk, comm);
+        }
+    }
+    MPI_Barrier(comm);
+    GET_TIME(t1);
+    res->time = t1 - t0;
+
+    // Έλεγχος: X[:, l] / (l + 1) έναντι του βρόχου SpMV (ως προς τη νόρμα max, όπως ο Check)
+    const double *Xo = mode == EXCH_HALO ? X : X + (size_t) lo * k;
+    double loc[2] = { 1.0, 0.0 };
+    for (int i = 0; i < m; i++) if (fabs(y_ref[i]) > loc[0]) loc[0] = fabs(y_ref[i]);
+    MPI_Allreduce(MPI_IN_PLACE, &loc[0], 1, MPI_DOUBLE, MPI_MAX, comm);
+    for (int i = 0; i < m; i++)
+        for (int l = 0; l < k; l++) {
+            double d = fabs(Xo[(size_t) i * k + l] / (l + 1) - y_ref[i]) / loc[0];
+            if (d > loc[1]) loc[1] = d;
+        }
+    MPI_Allreduce(&loc[1], &res->err, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    MPI_Type_free(&blk);
+    free(X); free(Y); free(counts);
+}
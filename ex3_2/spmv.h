@@ -0,0 +1,366 @@
+/* File:     spmv.h
+ *
+ * Purpose:  Κοινές δηλώσεις του ex3_2 (κατανεμημένο y = A * x σε CSR και
+ *           dense μορφή): δομή CSR, παράλληλη μετατροπή dense -> CSR, κατανεμημένη
+ *           παραγωγή του πίνακα, κοινόχρηστο διάνυσμα x ανά κόμβο, halo
+ *           exchange, επικάλυψη επικοινωνίας / υπολογισμού, μορφή
+ *           SELL-C-σ με αυτόματη επιλογή μορφής, φόρτωση από αρχείο και
+ *           αναδιάταξη RCM, επιλυτές CG / pipelined CG / power iteration,
+ *           SpMM με k διανύσματα, συμπαγές CSR, 2D πλέγμα διεργασιών,
+ *           διαμέριση γραμμών ισορροπημένη ως προς nnz, matrix powers (s-step).
+ *
+ * Σύμβαση: Οι γραμμές μοιράζονται σε συνεχή μπλοκ. Η διεργασία r κατέχει
+ *          τις γραμμές [row_off[r], row_off[r+1]) και το αντίστοιχο τμήμα του y.
+ *          Τα μπλοκ δεν έχουν απαραίτητα ίδιο μέγεθος (part.c): όλες οι
+ *          συλλογικές κλήσεις πάνω στο x / y είναι v-παραλλαγές.
+ */
+#ifndef _SPMV_H_
+#define _SPMV_H_
+
+#include <stdint.h>
+#include <mpi.h>
+
+/* Hybrid MPI + OpenMP: χωρίς -fopenmp ο κώδικας τρέχει με ένα νήμα */
+#ifdef _OPENMP
+#include <omp.h>
+#elif !defined(_OMP_STUBS_)
+#define _OMP_STUBS_   // Και στο perf.h: ορίζονται μία φορά, όποια σειρά κι αν έχουν τα #include
+static inline int omp_get_thread_num(void) { return 0; }
+static inline int omp_get_num_threads(void) { return 1; }
+static inline int omp_get_max_threads(void) { return 1; }
+static inline void omp_set_num_threads(int n) { (void) n; }
+#endif
+
+/* Τρόπος ανανέωσης του x στον βρόχο CSR */
+typedef enum {
+    EXCH_ALLGATHER = 0,    // Αρχικό: MPI_Allgather ολόκληρου του x
+    EXCH_HALO              // Μόνο τα ghosts κάθε διεργασίας (Neighbor_alltoallv)
+} exch_mode_t;
+
+/* --- Δομή CSR (Compressed Sparse Row) --- */
+typedef struct {
+    double *values;   // Μη-μηδενικές τιμές
+    int *col_ind;     // Δείκτες στήλης για κάθε τιμή
+    int *row_ptr;     // Δείκτες αρχής κάθε γραμμής
+    int n;            // Αριθμός γραμμών
+    int nnz;          // Πλήθος μη-μηδενικών στοιχείων (Number of Non-Zeros)
+} csr_t;
+
+/* --- csr.c --- */
+
+csr_t dense2csr(double *A_dense, int n);
+// rows x n dense γραμμές -> CSR (νήματα OpenMP, 64-bit μετρητές). nnz < 0 αν το
+// τμήμα δεν χωράει σε 32-bit δείκτες (> INT_MAX μη-μηδενικά)
+csr_t dense2csr_rows(const double *D, int rows, int n);
+void free_csr(csr_t *mat);
+// Scatter των γραμμών [row_off[r], row_off[r+1]) του CSR του Master σε κάθε r
+csr_t csr_scatter(const csr_t *global, const int *row_off, MPI_Comm comm);
+// Dense αντίγραφο των τοπικών γραμμών (A->n x n), με global δείκτες στηλών
+double *csr_to_dense_rows(const csr_t *A, int n);
+
+/* --- ccsr.c: Συμπαγές CSR (16-bit διαφορές στηλών, float / λεξικό τιμών) --- */
+
+#define CCSR_CHUNK 64          // Γραμμές ανά chunk (η κωδικοποίηση στηλών ξεκινά από 0)
+#define CCSR_ESC INT16_MIN     // Ακολουθούν 2 x 16 bit με την απόλυτη στήλη
+#define CCSR_DICT_MAX 256      // Διακριτές τιμές για δείκτη 8 bit
+#define CCSR_PROBE_ITERS 10    // SpMV για τη σύγκριση χρόνου CSR / συμπαγούς
+
+typedef enum { CVAL_DOUBLE = 0, CVAL_FLOAT, CVAL_DICT, CVAL_AUTO } cval_t;
+
+typedef struct {
+    int n, nnz, nchunks, ncols;
+    cval_t vmode;
+    int *row_ptr;          // Όπως στο CSR (δείκτες στις τιμές)
+    int *chunk_row;        // Πρώτη γραμμή κάθε chunk (nchunks + 1)
+    int *chunk_off;        // Αρχή κάθε chunk στη ροή cols (nchunks + 1)
+    int16_t *cols;         // Διαφορές στηλών (ncols λέξεις)
+    void *values;          // double / float / uint8_t (δείκτης στο dict)
+    int ndict;
+    double dict[CCSR_DICT_MAX];
+} ccsr_t;
+
+// Chunks των CCSR_CHUNK γραμμών που δεν περνούν τα όρια blk_off[0..nblk]
+// (για τη διανομή: blk_off = row_off). CVAL_AUTO: dict, αλλιώς float αν είναι
+// ακριβές, αλλιώς double. CVAL_DICT με > CCSR_DICT_MAX τιμές -> float αν είναι
+// ακριβές, αλλιώς double. Για τοπικά τμήματα: πρώτα το ccsr_vmode (συλλογική).
+ccsr_t ccsr_encode(const csr_t *A, const int *blk_off, int nblk, cval_t vmode);
+cval_t ccsr_vmode(const csr_t *A, cval_t vmode, MPI_Comm comm);
+csr_t ccsr_decode(const ccsr_t *C);
+void free_ccsr(ccsr_t *C);
+void ccsr_spmv(const ccsr_t *C, const double *x, double *y);
+// Bytes του πίνακα (στήλες, τιμές, row_ptr, chunks, λεξικό)
+size_t ccsr_bytes(const ccsr_t *C);
+int ccsr_float_exact(const csr_t *A);
+// Συλλογική: όπως το csr_scatter, με τη συμπαγή μορφή
+ccsr_t ccsr_scatter(const ccsr_t *global, const int *row_off, MPI_Comm comm);
+void ccsr_compare(const csr_t *A, const ccsr_t *C, const double *x, MPI_Comm comm,
+                  double *t_csr, double *t_ccsr);
+const char *cval_name(cval_t m);
+
+/* --- io.c: Matrix Market (.mtx) και native binary CSR μέσω MPI-IO --- */
+
+// Συλλογικές. Η μορφή αναγνωρίζεται από την κεφαλίδα του αρχείου. Το csr_load
+// επιστρέφει nnz < 0 (σε όλες τις διεργασίες) αν ένα .mtx έχει δείκτες εκτός
+// [1, n], ελλιπείς γραμμές ή πλήθος στοιχείων διαφορετικό από το NZ της κεφαλίδας.
+int csr_file_dims(const char *path, MPI_Comm comm, int *n, long long *nnz);
+csr_t csr_load(const char *path, const int *row_off, MPI_Comm comm);
+int csr_save(const char *path, const csr_t *A, const int *row_off, MPI_Comm comm);
+
+// Τριάδα (global γραμμή, global στήλη) με την τιμή σε χωριστό πίνακα
+typedef struct { int row, col; } csr_ij_t;
+// Συλλογική: στέλνει κάθε τριάδα στον ιδιοκτήτη της γραμμής της (row_off) και
+// επιστρέφει το τοπικό CSR (στήλες ταξινομημένες ανά γραμμή)
+csr_t csr_from_triplets(const csr_ij_t *ij, const double *v, size_t cnt, const int *row_off, MPI_Comm comm);
+
+/* --- part.c: Διαμέριση γραμμών (ομοιόμορφη ή ισορροπημένη ως προς nnz) --- */
+
+// n / P γραμμές, +1 στις πρώτες n % P διεργασίες
+void part_uniform(int n, int P, int *row_off);
+// Γραμμές ανά διεργασία (counts για τα v-collectives, malloc)
+int *part_counts(const int *row_off, int P);
+// Συλλογική στο comm: όρια P τμημάτων με ~ίσα nnz από τις γραμμές [lo, lo + A->n)
+// κάθε διεργασίας (για τον πίνακα του Master: lo = 0 και MPI_COMM_SELF)
+void part_nnz(const csr_t *A, int lo, int n, int P, MPI_Comm comm, int *row_off);
+// max / mean nnz ανά διεργασία: από global row_ptr ή από τα τοπικά CSR (συλλογική)
+double part_imbalance(const int *row_ptr, const int *row_off, int P);
+double part_imbalance_dist(const csr_t *A, MPI_Comm comm);
+// Συλλογική: οι γραμμές [lo, lo + A->n) στους ιδιοκτήτες κατά new_off
+csr_t part_redistribute(const csr_t *A, int lo, const int *new_off, MPI_Comm comm);
+
+/* --- gen.c: Παραγωγή γραμμών με counter-based RNG (ίδιος πίνακας για κάθε P) --- */
+
+#define GEN_SEED 42
+
+double gen_entry(uint64_t seed, int n, int i, int j, double sparsity);
+csr_t gen_csr_rows(int n, int row_lo, int row_hi, double sparsity, uint64_t seed);
+double *gen_dense_rows(int n, int row_lo, int row_hi, double sparsity, uint64_t seed);
+
+/* --- halo.c: Ανταλλαγή μόνο των στοιχείων του x που χρειάζεται κάθε διεργασία --- */
+
+typedef struct {
+    int local_n, nghost;
+    int *ghost_cols;       // Global στήλες των ghosts (ταξινομημένες)
+    int nrecv, nsend;      // Πλήθος γειτόνων
+    int *recv_ranks, *recv_counts, *recv_displs;
+    int *send_ranks, *send_counts, *send_displs;
+    int nsend_vals;
+    int *send_idx;         // Τοπικοί δείκτες των τιμών που στέλνουμε
+    double *send_buf;
+    MPI_Comm graph;        // Γράφος γειτόνων (Neighbor_alltoallv)
+    int blk_k;             // SpMM: k του blk_type / blk_buf (0 = δεν έχουν δημιουργηθεί)
+    MPI_Datatype blk_type;
+    double *blk_buf;
+} halo_t;
+
+// Συλλογική. Επαναριθμεί το A->col_ind σε [0, local_n + nghost).
+void halo_setup(halo_t *h, csr_t *A, const int *row_off, MPI_Comm comm);
+// Αρχικό τοπικό x (local_n + nghost) από το πλήρες x
+void halo_init_x(const halo_t *h, const double *x_global, int lo, double *x_loc);
+// Ανανέωση των ghosts του x_loc από τους γείτονες (ανασταλτική / μη-ανασταλτική)
+void halo_exchange(halo_t *h, double *x_loc);
+void halo_ibegin(halo_t *h, double *x_loc, MPI_Request *req);
+// k διανύσματα (row-major X) σε μία ανταλλαγή
+void halo_exchange_block(halo_t *h, double *X, int k);
+void halo_free(halo_t *h);
+
+/* --- overlap.c: Interior γραμμές όσο η ανανέωση του x είναι σε εξέλιξη --- */
+
+#define OVL_CALIB_REPS 5   // Ανασταλτικές ανταλλαγές για τη μέτρηση αναφοράς
+
+typedef struct {
+    int n_int, n_bnd;
+    int *rows_int;         // Γραμμές που διαβάζουν μόνο στήλες [col_lo, col_hi)
+    int *rows_bnd;         // Οι υπόλοιπες
+} ovl_split_t;
+
+typedef struct {
+    double interior;       // Υπολογισμός όσο η επικοινωνία είναι σε εξέλιξη
+    double wait;           // Χρόνος μπλοκαρίσματος σε Wait (μη-κρυμμένη επικοινωνία)
+    double boundary;       // Υπολογισμός μετά την άφιξη των δεδομένων
+    int nexch;             // Πλήθος ανταλλαγών
+} ovl_times_t;
+
+void ovl_split(ovl_split_t *s, const csr_t *A, int col_lo, int col_hi);
+void ovl_split_free(ovl_split_t *s);
+// Μέσος χρόνος μίας ανασταλτικής ανανέωσης του x (για το ποσοστό που κρύφτηκε)
+double ovl_calibrate(exch_mode_t mode, halo_t *halo, const double *x, int n, const int *row_off);
+// Ίδιο αποτέλεσμα με τον ανασταλτικό βρόχο: στο τέλος το x (πλήρες ή x_loc) = A^iters x
+void ovl_csr_loop(const csr_t *A, const ovl_split_t *s, exch_mode_t mode, halo_t *halo,
+                  double *x, const int *row_off, int iters, double *y, ovl_times_t *t);
+void ovl_dense_loop(const double *A, int n, double *x, const int *row_off, int iters,
+                    double *y, ovl_times_t *t);
+
+/* --- sell.c: SELL-C-σ (sliced ELLPACK) και επιλογή μορφής --- */
+
+#define SELL_C        8      // Γραμμές ανά chunk (= double lanes του AVX-512)
+#define SELL_SIGMA    256    // Παράθυρο ταξινόμησης (πολλαπλάσιο του SELL_C)
+#define SELL_MIN_FILL 0.80   // Ελάχιστη πληρότητα nnz / stored για SELL
+#define SELL_MIN_ROW  4.0    // Ελάχιστο μέσο μήκος γραμμής για SELL
+#define FMT_DENSE_MIN (2.0 / 3.0)   // Πυκνότητα πάνω από την οποία το dense μεταφέρει λιγότερα bytes
+
+typedef struct {
+    int n, sigma, nchunks, nnz, nnz_stored;
+    int *chunk_ptr;        // Αρχή κάθε chunk στα values / col_ind
+    int *chunk_len;        // Μήκος (στήλες) κάθε chunk
+    int *perm;             // Θέση -> αρχική τοπική γραμμή (-1 = συμπλήρωμα)
+    double *values;        // Column-major μέσα στο chunk
+    int *col_ind;
+} sell_t;
+
+typedef enum { FMT_CSR = 0, FMT_SELL, FMT_DENSE, FMT_AUTO } fmt_t;
+
+typedef struct {
+    double mean, cv;       // Μέσο μήκος γραμμής και συντελεστής μεταβλητότητας
+    double density;        // nnz / n^2
+    double fill;           // nnz / stored στο SELL-C-σ
+} fmt_stats_t;
+
+sell_t csr2sell(const csr_t *A, int sigma);
+void free_sell(sell_t *S);
+void sell_spmv(const sell_t *S, const double *x, double *y);
+const char *sell_isa_name(void);
+fmt_t fmt_select(const csr_t *A, int n, int sigma, MPI_Comm comm, fmt_stats_t *st);
+const char *fmt_name(fmt_t f);
+
+/* --- rcm.c: Αναδιάταξη Reverse Cuthill-McKee --- */
+
+#define RCM_PROBE_ITERS 10   // Επαναλήψεις SpMV για τη σύγκριση πριν / μετά
+
+typedef struct {
+    long long bandwidth;     // max |i - j| για a_ij != 0
+    long long profile;       // Σ_i (i - min{j : a_ij != 0, j <= i})
+} rcm_stats_t;
+
+// Συλλογική: η μετάθεση υπολογίζεται στον Master από το συμμετρικό μοτίβο
+// A + A^T και μοιράζεται σε όλους. perm[νέος] = παλιός δείκτης.
+int *rcm_order(const csr_t *local, const int *row_off, int n, MPI_Comm comm);
+// Συλλογική: B = P A P^T με τις γραμμές του B στους ιδιοκτήτες κατά row_off
+csr_t rcm_permute(const csr_t *local, const int *row_off, const int *perm, int n, MPI_Comm comm);
+// Συλλογική: bandwidth / profile του κατανεμημένου πίνακα (global στήλες)
+rcm_stats_t rcm_stats(const csr_t *local, int lo, MPI_Comm comm);
+// Συλλογική: χρόνος ανά επανάληψη SpMV + ανανέωση x (allgather ή halo, max
+// ως προς τις διεργασίες) και ghost στοιχεία (halo, άθροισμα)
+double rcm_probe(const csr_t *local, exch_mode_t mode, const int *row_off, int n,
+                 MPI_Comm comm, long long *ghosts);
+
+/* --- krylov.c: Επιλυτές πάνω στο κατανεμημένο SpMV --- */
+
+#define KRYLOV_TOL 1e-8      // Default σχετικό υπόλοιπο τερματισμού
+#define KRYLOV_MAXIT 1000    // Default μέγιστες επαναλήψεις
+
+typedef enum { SOLVER_NONE = 0, SOLVER_CG, SOLVER_PIPECG, SOLVER_POWER } solver_t;
+
+typedef struct {
+    int iters, converged;
+    int breakdown;           // CG / pipecg: (p, Ap) <= 0 ή μη πεπερασμένο α (A όχι SPD)
+    int reductions;          // Global Allreduce ανά επανάληψη
+    double resid;            // CG: ||r|| / ||b||, power: ||A x - λ x|| / |λ|
+    double time;             // Χρόνος επίλυσης (πιο αργή διεργασία)
+    double lambda;           // Power: κυρίαρχη ιδιοτιμή
+    double err;              // CG: max |x - 1| (b = A * 1)
+} krylov_result_t;
+
+// Συλλογική. Το A (και το sell, αν δεν είναι NULL) έχει στήλες σύμφωνα με το
+// mode: global για allgather, επαναριθμημένες από το halo_setup για halo.
+void krylov_solve(solver_t solver, const csr_t *A, const sell_t *sell, exch_mode_t mode, halo_t *halo,
+                  const int *row_off, int maxit, double tol, MPI_Comm comm, krylov_result_t *res);
+const char *solver_name(solver_t s);
+
+/* --- spmm.c: Y = A X για k διανύσματα (row-major X, SIMD κατά μήκος των k) --- */
+
+typedef struct {
+    int k;
+    double time;             // Χρόνος βρόχου (iters επαναλήψεις, τοπικός)
+    double work;             // Χρόνος πυρήνα χωρίς επικοινωνία (τοπικός)
+    double err;              // max |X[:, l] / (l + 1) - y_ref| / max |y_ref| (global)
+} spmm_result_t;
+
+// Y (A->n x k) = A X. Οι στήλες του A δεικτοδοτούν γραμμές του X.
+void spmm_csr(const csr_t *A, const double *X, int k, double *Y);
+// Συλλογική: iters επαναλήψεις X = A X με X0[:, l] = (l + 1) x0 (x0: πλήρες
+// διάνυσμα, global αρίθμηση) και μία ανανέωση του X ανά επανάληψη. y_ref: το
+// τοπικό τμήμα του A^iters x0 από τον βρόχο SpMV.
+void spmm_run(const csr_t *A, exch_mode_t mode, halo_t *halo, const int *row_off, int k, int iters,
+              const double *x0, const double *y_ref, MPI_Comm comm, spmm_result_t *res);
+const char *spmm_isa_name(void);
+
+/* --- mpk.c: Matrix powers, s βήματα ανά ανταλλαγή --- */
+
+typedef struct {
+    int s, local_n;
+    csr_t E;                 // Γραμμές του R_{s-1} κατά επίπεδο, στήλες στο τοπικό x (halo)
+    int *lvl_rows;           // lvl_rows[k]: γραμμές του E στο R_k (k = 0..s)
+    int *row_g, *row_x;      // Κάθε γραμμή του E: global δείκτης / θέση στο τοπικό x
+    halo_t halo;             // Ghosts = R_s \ R_0, μία ανταλλαγή ανά s βήματα
+    double *buf[2];          // local_n + nghost (εναλλάσσονται ανά βήμα)
+} mpk_t;
+
+typedef struct {
+    int s, nexch;            // Βάθος, ανταλλαγές στον βρόχο
+    double time;             // Χρόνος βρόχου (iters επαναλήψεις)
+    double extra;            // Πλεονάζουσες πράξεις / πράξεις των iters SpMV (global)
+    long long msgs, ghosts;  // Μηνύματα στον βρόχο, ghosts ανά ανταλλαγή (άθροισμα)
+    double err;              // max |y - y_ref| / max |y_ref|
+} mpk_result_t;
+
+// Συλλογική: επίπεδα R_1..R_s από το col_ind (A: τοπικές γραμμές, global στήλες),
+// λήψη των ξένων γραμμών έως το R_{s-1} και σχέδιο ανταλλαγής του R_s \ R_0
+void mpk_setup(mpk_t *m, const csr_t *A, const int *row_off, int s, MPI_Comm comm);
+void mpk_free(mpk_t *m);
+// Συλλογική: iters επαναλήψεις x = A x από το x0 (πλήρες), μία ανταλλαγή ανά s.
+// y_ref: το τοπικό τμήμα του A^iters x0 από τον βρόχο SpMV.
+void mpk_run(mpk_t *m, const double *x0, int lo, int iters, const double *y_ref,
+             MPI_Comm comm, mpk_result_t *res);
+
+/* --- grid2d.c: 2D διάσπαση σε πλέγμα sqrt(P) x sqrt(P) --- */
+
+typedef struct {
+    MPI_Comm cart, row, col;   // Πλέγμα, γραμμή (rank = pc), στήλη (rank = pr)
+    int q, pr, pc;             // P = q^2, συντεταγμένες (i, j)
+    int nb;                    // n / q
+    int row_lo, col_lo;        // Πρώτη global γραμμή / στήλη του μπλοκ
+    double *xj, *ypart, *yi;   // x_j, y_ij = A_ij x_j, y_i (διαγώνιες)
+} grid2d_t;
+
+// Συλλογική. -1 αν το P δεν είναι τέλειο τετράγωνο ή το q δεν διαιρεί το n.
+int grid2d_create(grid2d_t *g, int n, MPI_Comm comm);
+void grid2d_free(grid2d_t *g);
+// Συλλογική: μπλοκ A_ij (τοπικές γραμμές / στήλες) από τις γραμμές [lo, lo + local->n)
+csr_t grid2d_csr(const grid2d_t *g, const csr_t *local, int lo);
+// Συλλογική: τα dense μπλοκ nb x nb από τον πίνακα του Master
+double *grid2d_scatter_dense(const grid2d_t *g, const double *A_global, int n);
+// iters επαναλήψεις x = A x από το x0 (πλήρες). Επιστρέφει τον χρόνο πυρήνα.
+double grid2d_csr_loop(grid2d_t *g, const csr_t *B, const double *x0, int iters);
+double grid2d_dense_loop(grid2d_t *g, const double *D, const double *x0, int iters);
+// Συλλογική: το τελικό x στον Master
+void grid2d_gather(const grid2d_t *g, double *x_root);
+
+/* --- shm.c: Ένα αντίγραφο του x ανά κόμβο (MPI-3 shared windows) --- */
+
+typedef struct {
+    MPI_Comm node;         // Διεργασίες του ίδιου κόμβου
+    MPI_Comm leaders;      // Node rank 0 κάθε κόμβου (αλλιώς MPI_COMM_NULL)
+    int node_rank, node_size, nnodes;
+    MPI_Win win;
+    double *buf[2];        // Τρέχον / επόμενο x (κοινά σε όλο τον κόμβο)
+    int cur;
+    int n;
+    // Μόνο στους leaders: Allgatherv των τμημάτων κάθε κόμβου
+    int *counts, *displs;  // Ανά κόμβο, σε "packed" σειρά
+    int *order;            // World ranks σε packed σειρά
+    int *node_first;       // order[node_first[d] .. node_first[d+1]): ranks του κόμβου d
+    const int *row_off;
+    double *pack, *recv;
+} shm_vec_t;
+
+// Συλλογική (MPI_COMM_WORLD). row_off: P+1 όρια γραμμών.
+void shm_vec_create(shm_vec_t *v, int n, const int *row_off);
+// Αντιγραφή του x_root (Master) στο τρέχον x όλων των κόμβων
+void shm_vec_bcast(shm_vec_t *v, const double *x_root);
+// Το τρέχον x (μόνο για ανάγνωση εντός της επανάληψης)
+static inline double *shm_vec_x(shm_vec_t *v) { return v->buf[v->cur]; }
+// Αντικαθιστά το Allgather: local_y -> επόμενο x, ανταλλαγή μεταξύ leaders, swap
+void shm_vec_exchange(shm_vec_t *v, const double *local_y);
+void shm_vec_free(shm_vec_t *v);
+
+#endif